@@ -19,7 +19,6 @@
 #include <QEventLoop>
 #include <QMimeData>
 #include <QUrl>
-#include <QFileSystemWatcher>
 #include <QSet>
 #include <QDebug>
 
@@ -44,11 +43,10 @@ IconList::IconList(const QStringList &builtinPaths, QString path, QObject *paren
 		addThemeIcon(builtinName);
 	}
 
-	m_watcher.reset(new QFileSystemWatcher());
+	m_watcher = new DirectoryWatcher(this);
+	m_watcher->setFilter(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable);
 	is_watching = false;
-	connect(m_watcher.get(), SIGNAL(directoryChanged(QString)),
-			SLOT(directoryChanged(QString)));
-	connect(m_watcher.get(), SIGNAL(fileChanged(QString)), SLOT(fileChanged(QString)));
+	connect(m_watcher, &DirectoryWatcher::changed, this, &IconList::directoryContentsChanged);
 
 	directoryChanged(path);
 }
@@ -62,6 +60,7 @@ void IconList::directoryChanged(const QString &path)
 		m_dir.refresh();
 		if(is_watching)
 			stopWatching();
+		m_watcher->setDirectory(m_dir.absolutePath());
 		startWatching();
 	}
 	if(!m_dir.exists())
@@ -92,38 +91,62 @@ void IconList::directoryChanged(const QString &path)
 
 	for (auto remove : to_remove)
 	{
-		qDebug() << "Removing " << remove;
-		QFileInfo rmfile(remove);
-		QString key = rmfile.baseName();
-		int idx = getIconIndex(key);
-		if (idx == -1)
-			continue;
-		icons[idx].remove(IconType::FileBased);
-		if (icons[idx].type() == IconType::ToBeDeleted)
-		{
-			beginRemoveRows(QModelIndex(), idx, idx);
-			icons.remove(idx);
-			reindex();
-			endRemoveRows();
-		}
-		else
-		{
-			dataChanged(index(idx), index(idx));
-		}
-		m_watcher->removePath(remove);
-		emit iconUpdated(key);
+		removeFileIcon(remove);
 	}
 
 	for (auto add : to_add)
 	{
-		qDebug() << "Adding " << add;
-		QFileInfo addfile(add);
-		QString key = addfile.baseName();
-		if (addIcon(key, QString(), addfile.filePath(), IconType::FileBased))
-		{
-			m_watcher->addPath(add);
-			emit iconUpdated(key);
-		}
+		addFileIcon(add);
+	}
+}
+
+void IconList::directoryContentsChanged(const DirectoryWatcher::Changes &changes)
+{
+	for (auto &name : changes.removed)
+	{
+		removeFileIcon(m_dir.filePath(name));
+	}
+	for (auto &name : changes.added)
+	{
+		addFileIcon(m_dir.filePath(name));
+	}
+	for (auto &name : changes.changed)
+	{
+		fileChanged(m_dir.filePath(name));
+	}
+}
+
+void IconList::removeFileIcon(const QString &path)
+{
+	qDebug() << "Removing " << path;
+	QFileInfo rmfile(path);
+	QString key = rmfile.baseName();
+	int idx = getIconIndex(key);
+	if (idx == -1)
+		return;
+	icons[idx].remove(IconType::FileBased);
+	if (icons[idx].type() == IconType::ToBeDeleted)
+	{
+		beginRemoveRows(QModelIndex(), idx, idx);
+		icons.remove(idx);
+		reindex();
+		endRemoveRows();
+	}
+	else
+	{
+		dataChanged(index(idx), index(idx));
+	}
+	emit iconUpdated(key);
+}
+
+void IconList::addFileIcon(const QString &path)
+{
+	qDebug() << "Adding " << path;
+	QFileInfo addfile(path);
+	QString key = addfile.baseName();
+	if (addIcon(key, QString(), addfile.filePath(), IconType::FileBased))
+	{
+		emit iconUpdated(key);
 	}
 }
 
@@ -158,7 +181,7 @@ void IconList::startWatching()
 {
 	auto abs_path = m_dir.absolutePath();
 	FS::ensureFolderPathExists(abs_path);
-	is_watching = m_watcher->addPath(abs_path);
+	is_watching = m_watcher->start();
 	if (is_watching)
 	{
 		qDebug() << "Started watching " << abs_path;
@@ -171,8 +194,7 @@ void IconList::startWatching()
 
 void IconList::stopWatching()
 {
-	m_watcher->removePaths(m_watcher->files());
-	m_watcher->removePaths(m_watcher->directories());
+	m_watcher->stop();
 	is_watching = false;
 }
 
@@ -25,11 +25,10 @@
 #include "settings/Setting.h"
 #include "Env.h" // there is a global icon list inside Env.
 #include <icons/IIconList.h>
+#include <DirectoryWatcher.h>
 
 #include "multimc_gui_export.h"
 
-class QFileSystemWatcher;
-
 class MULTIMC_GUI_EXPORT IconList : public QAbstractListModel, public IIconList
 {
 	Q_OBJECT
@@ -70,15 +69,18 @@ private:
 	// hide assign op
 	IconList &operator=(const IconList &) = delete;
 	void reindex();
+	void addFileIcon(const QString &path);
+	void removeFileIcon(const QString &path);
 
 public slots:
 	void directoryChanged(const QString &path);
 
 protected slots:
+	void directoryContentsChanged(const DirectoryWatcher::Changes &changes);
 	void fileChanged(const QString &path);
 	void SettingChanged(const Setting & setting, QVariant value);
 private:
-	std::shared_ptr<QFileSystemWatcher> m_watcher;
+	DirectoryWatcher *m_watcher;
 	bool is_watching;
 	QMap<QString, int> name_index;
 	QVector<MMCIcon> icons;
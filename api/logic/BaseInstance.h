@@ -119,7 +119,7 @@ public:
 	QString getPostExitCommand();
 	QString getWrapperCommand();
 
-	/// guess log level from a line of game log
+	/// guess log level from a line of game log. This is called from worker threads and must not touch the instance state
 	virtual MessageLevel::Enum guessLevel(const QString &line, MessageLevel::Enum level)
 	{
 		return level;
@@ -226,6 +226,12 @@ public:
 
 	virtual bool reload();
 
+	/**
+	 * Drop state that is loaded on demand (like the version profile or mod lists) if nothing is using it.
+	 * Called when the instance is no longer selected. It gets loaded again when needed.
+	 */
+	virtual void releaseResources() {}
+
 	/**
 	 * 'print' a verbose desription of the instance into a QStringList
 	 */
@@ -2,6 +2,9 @@
 
 #include <QObject>
 #include <QString>
+#include <QMap>
+#include <functional>
+#include <memory>
 #include "BaseInstance.h"
 #include "settings/SettingsObject.h"
 
@@ -10,6 +13,15 @@
 using InstanceId = QString;
 using InstanceLocator = std::pair<InstancePtr, int>;
 
+/// Whatever a provider reads from disk ahead of creating an instance
+class MULTIMC_LOGIC_EXPORT InstancePrefetch
+{
+public:
+	virtual ~InstancePrefetch() {}
+};
+using InstancePrefetchPtr = std::shared_ptr<InstancePrefetch>;
+using InstancePrefetcher = std::function<InstancePrefetchPtr(const InstanceId &)>;
+
 enum class InstCreateError
 {
 	NoCreateError = 0,
@@ -30,6 +42,41 @@ public:
 public:
 	virtual QList<InstanceId> discoverInstances() = 0;
 	virtual InstancePtr loadInstance(const InstanceId &id) = 0;
+
+	/**
+	 * Instances can be loaded in two steps. The prefetcher reads what it can from disk and
+	 * is called on worker threads, so it must not touch the provider. Then loadInstance creates
+	 * the instance from the prefetched data on the main thread.
+	 * @return the prefetcher, or nothing if there is nothing to do ahead of time
+	 */
+	virtual InstancePrefetcher prefetcher()
+	{
+		return nullptr;
+	}
+	virtual InstancePtr loadInstance(const InstanceId &id, const InstancePrefetchPtr &prefetch)
+	{
+		Q_UNUSED(prefetch);
+		return loadInstance(id);
+	}
+
+	/**
+	 * The instances the provider had last time, with what loadInstance needs to create them
+	 * without reading anything else. They are checked by the next discoverInstances.
+	 */
+	virtual QMap<InstanceId, InstancePrefetchPtr> snapshot()
+	{
+		return {};
+	}
+	/// @return true if an instance created from the snapshot turned out to be out of date when discovering instances
+	virtual bool isStale(const InstanceId &id)
+	{
+		Q_UNUSED(id);
+		return false;
+	}
+	/// Remember the instances for next time
+	virtual void saveSnapshot()
+	{
+	}
 	virtual void loadGroupList() = 0;
 	virtual void saveGroupList() = 0;
 
@@ -0,0 +1,239 @@
+#include "ContentStore.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QAtomicInt>
+#include <QHash>
+#include <QVector>
+#include <QtEndian>
+#include <QtConcurrentMap>
+#include <QDebug>
+
+#if defined Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+/*
+ * The verification ledger: "MMCLEDGR", quint32 version, quint32 reserved,
+ * then 48 byte records, all little endian:
+ *   20 bytes SHA-1, 4 bytes reserved, quint64 inode, qint64 timestamp (ms), qint64 size
+ */
+const char ledgerMagic[8] = {'M', 'M', 'C', 'L', 'E', 'D', 'G', 'R'};
+const quint32 ledgerVersion = 1;
+const int ledgerHeaderSize = 16;
+const int ledgerRecordSize = 48;
+
+struct Stamp
+{
+	quint64 inode = 0;
+	qint64 timestamp = 0;
+	qint64 size = -1;
+	bool operator==(const Stamp &other) const
+	{
+		return inode == other.inode && timestamp == other.timestamp && size == other.size;
+	}
+};
+
+// the inode is only there on platforms that have them
+bool stampFile(const QString &path, Stamp &out)
+{
+#if defined Q_OS_UNIX
+	struct stat fileStat;
+	if (::stat(QFile::encodeName(path).constData(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+	{
+		return false;
+	}
+	out.inode = fileStat.st_ino;
+#endif
+	QFileInfo info(path);
+	if (!info.isFile())
+	{
+		return false;
+	}
+	out.size = info.size();
+	out.timestamp = info.lastModified().toMSecsSinceEpoch();
+	return true;
+}
+
+QHash<QByteArray, Stamp> readLedger(const QString &path)
+{
+	QHash<QByteArray, Stamp> ledger;
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return ledger;
+	}
+	auto data = file.readAll();
+	auto raw = reinterpret_cast<const uchar *>(data.constData());
+	if (data.size() < ledgerHeaderSize || memcmp(raw, ledgerMagic, sizeof(ledgerMagic)) != 0 ||
+		qFromLittleEndian<quint32>(raw + 8) != ledgerVersion)
+	{
+		qWarning() << "Ignoring unknown verification ledger" << path;
+		return ledger;
+	}
+	int count = (data.size() - ledgerHeaderSize) / ledgerRecordSize;
+	ledger.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		auto record = raw + ledgerHeaderSize + i * ledgerRecordSize;
+		Stamp stamp;
+		stamp.inode = qFromLittleEndian<quint64>(record + 24);
+		stamp.timestamp = qFromLittleEndian<qint64>(record + 32);
+		stamp.size = qFromLittleEndian<qint64>(record + 40);
+		ledger.insert(QByteArray(reinterpret_cast<const char *>(record), 20), stamp);
+	}
+	return ledger;
+}
+
+void writeLedger(const QString &path, const QHash<QByteArray, Stamp> &ledger)
+{
+	QByteArray data(ledgerHeaderSize + ledger.size() * ledgerRecordSize, '\0');
+	auto raw = reinterpret_cast<uchar *>(data.data());
+	memcpy(raw, ledgerMagic, sizeof(ledgerMagic));
+	qToLittleEndian<quint32>(ledgerVersion, raw + 8);
+	auto record = raw + ledgerHeaderSize;
+	for (auto iter = ledger.begin(); iter != ledger.end(); iter++, record += ledgerRecordSize)
+	{
+		memcpy(record, iter.key().constData(), 20);
+		qToLittleEndian<quint64>(iter.value().inode, record + 24);
+		qToLittleEndian<qint64>(iter.value().timestamp, record + 32);
+		qToLittleEndian<qint64>(iter.value().size, record + 40);
+	}
+	try
+	{
+		FS::write(path, data);
+	}
+	catch (Exception &e)
+	{
+		qWarning() << "Couldn't write the verification ledger:" << e.what();
+	}
+}
+}
+
+ContentStore::ContentStore(const QString &root) : m_root(root)
+{
+}
+
+QString ContentStore::objectPath(const QString &sha1) const
+{
+	return FS::PathCombine(m_root, sha1.left(2), sha1);
+}
+
+bool ContentStore::contains(const QString &sha1) const
+{
+	return QFileInfo(objectPath(sha1)).isFile();
+}
+
+FS::CloneMethod ContentStore::materialise(const QString &sha1, const QString &target, bool allowHardlink) const
+{
+	return FS::cloneFile(objectPath(sha1), target, allowHardlink);
+}
+
+bool ContentStore::isLinked(const QString &sha1, const QString &target) const
+{
+#if defined Q_OS_UNIX
+	struct stat objectStat;
+	struct stat targetStat;
+	if (::stat(QFile::encodeName(objectPath(sha1)).constData(), &objectStat) != 0)
+	{
+		return false;
+	}
+	if (::stat(QFile::encodeName(target).constData(), &targetStat) != 0)
+	{
+		return false;
+	}
+	return objectStat.st_dev == targetStat.st_dev && objectStat.st_ino == targetStat.st_ino;
+#else
+	Q_UNUSED(sha1);
+	Q_UNUSED(target);
+	return false;
+#endif
+}
+
+QStringList ContentStore::verify(const QStringList &sha1s, std::function<void(int, int)> progress,
+	const QAtomicInt *cancel) const
+{
+	struct Work
+	{
+		QString sha1;
+		QByteArray rawSha1;
+		Stamp stamp;
+		bool checked = false;
+		bool known = false;
+		bool ok = false;
+	};
+
+	auto ledgerPath = FS::PathCombine(m_root, ".verified");
+	auto ledger = readLedger(ledgerPath);
+
+	QVector<Work> work;
+	work.reserve(sha1s.size());
+	for (auto &sha1 : sha1s)
+	{
+		Work item;
+		item.sha1 = sha1;
+		item.rawSha1 = QByteArray::fromHex(sha1.toLatin1());
+		work.append(item);
+	}
+
+	QAtomicInt done;
+	const int total = work.size();
+	auto check = [&](Work &item)
+	{
+		if (cancel && cancel->loadAcquire())
+		{
+			return;
+		}
+		item.checked = true;
+		auto path = objectPath(item.sha1);
+		if (stampFile(path, item.stamp))
+		{
+			auto iter = ledger.constFind(item.rawSha1);
+			item.known = iter != ledger.constEnd() && iter.value() == item.stamp;
+			item.ok = item.known || FS::hashFile(path, QCryptographicHash::Sha1) == item.rawSha1;
+			if (!item.ok)
+			{
+				qWarning() << "Removing corrupt object" << path;
+				QFile::remove(path);
+			}
+		}
+		int count = done.fetchAndAddOrdered(1) + 1;
+		if (progress && (count % 64 == 0 || count == total))
+		{
+			progress(count, total);
+		}
+	};
+	QtConcurrent::blockingMap(work, check);
+
+	QStringList bad;
+	int hashed = 0;
+	bool changed = false;
+	for (const auto &item : work)
+	{
+		if (!item.checked)
+		{
+			continue;
+		}
+		if (!item.ok)
+		{
+			bad.append(item.sha1);
+			changed |= ledger.remove(item.rawSha1) != 0;
+			continue;
+		}
+		if (!item.known)
+		{
+			hashed++;
+			ledger.insert(item.rawSha1, item.stamp);
+			changed = true;
+		}
+	}
+	qDebug() << "Verified" << total << "objects:" << hashed << "hashed," << bad.size() << "missing or corrupt";
+	if (changed)
+	{
+		writeLedger(ledgerPath, ledger);
+	}
+	return bad;
+}
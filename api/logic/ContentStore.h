@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QAtomicInt>
+#include <functional>
+
+#include "FileSystem.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * A folder of files addressed by the SHA-1 of their contents, laid out as <root>/<first two hex digits>/<hash>.
+ *
+ * This is the layout of assets/objects. Files are taken out of the store by cloning them
+ * (reflink, hard link or copy), so the same contents don't have to be duplicated on disk.
+ */
+class MULTIMC_LOGIC_EXPORT ContentStore
+{
+public:
+	explicit ContentStore(const QString &root);
+
+	/// Path of the object with the given hex SHA-1
+	QString objectPath(const QString &sha1) const;
+
+	/// Is the object with the given hex SHA-1 present?
+	bool contains(const QString &sha1) const;
+
+	/**
+	 * Make target have the contents of the object with the given hex SHA-1.
+	 * Hard links are used only when allowHardlink is true - the target then shares the object file.
+	 */
+	FS::CloneMethod materialise(const QString &sha1, const QString &target, bool allowHardlink = true) const;
+
+	/// Is target the object itself, through a hard link?
+	bool isLinked(const QString &sha1, const QString &target) const;
+
+	/**
+	 * Check the objects with the given hex SHA-1s against their contents, spread over the global thread pool.
+	 * Corrupt objects are removed. Returns the ones that are missing or were removed.
+	 *
+	 * Objects that passed are recorded in a ledger in the store, along with their inode, timestamp and size.
+	 * They are not hashed again until one of those changes.
+	 *
+	 * progress is called with (done, total) from any thread.
+	 * Once cancel is set, the remaining objects are skipped and not reported.
+	 */
+	QStringList verify(const QStringList &sha1s, std::function<void(int, int)> progress = nullptr,
+		const QAtomicInt *cancel = nullptr) const;
+
+private:
+	QString m_root;
+};
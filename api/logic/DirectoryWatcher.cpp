@@ -0,0 +1,328 @@
+#include "DirectoryWatcher.h"
+
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+#include <QDateTime>
+#include <QDebug>
+
+#if defined Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+DirectoryWatcher::DirectoryWatcher(QObject *parent) : QObject(parent)
+{
+	m_timer.setSingleShot(true);
+	m_timer.setInterval(250);
+	connect(&m_timer, &QTimer::timeout, this, &DirectoryWatcher::flush);
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+	stop();
+}
+
+void DirectoryWatcher::setDirectory(const QString &path)
+{
+	bool wasWatching = m_watching;
+	stop();
+	m_dir.setPath(path);
+	m_snapshot.clear();
+	if (wasWatching)
+	{
+		start();
+	}
+}
+
+void DirectoryWatcher::setFilter(QDir::Filters filters)
+{
+	m_filters = filters;
+}
+
+void DirectoryWatcher::setDelay(int msecs)
+{
+	m_timer.setInterval(msecs);
+}
+
+bool DirectoryWatcher::start()
+{
+	if (m_watching)
+	{
+		return true;
+	}
+	m_snapshot = snapshot();
+	m_touched.clear();
+	m_fullScan = false;
+	m_watching = arm();
+	return m_watching;
+}
+
+bool DirectoryWatcher::arm()
+{
+	if (startInotify())
+	{
+		return true;
+	}
+	if (!m_watcher)
+	{
+		m_watcher = new QFileSystemWatcher(this);
+		connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &DirectoryWatcher::directoryChanged);
+	}
+	return m_watcher->addPath(m_dir.absolutePath());
+}
+
+// the folder went away or came back, the old watch is useless either way
+void DirectoryWatcher::rearm()
+{
+	stopInotify();
+	if (m_watcher && !m_watcher->directories().isEmpty())
+	{
+		m_watcher->removePaths(m_watcher->directories());
+	}
+	if (arm())
+	{
+		return;
+	}
+	// wait for the folder to come back, by watching the closest folder above it that's still there
+	QString parent = QFileInfo(m_dir.absolutePath()).absolutePath();
+	while (!QFileInfo(parent).isDir())
+	{
+		auto up = QFileInfo(parent).absolutePath();
+		if (up == parent)
+		{
+			break;
+		}
+		parent = up;
+	}
+	if (!m_watcher->addPath(parent))
+	{
+		qWarning() << "Lost track of" << m_dir.absolutePath();
+	}
+}
+
+void DirectoryWatcher::stop()
+{
+	m_timer.stop();
+	stopInotify();
+	if (m_watcher)
+	{
+		m_watcher->removePaths(m_watcher->directories());
+	}
+	m_watching = false;
+}
+
+void DirectoryWatcher::rescan()
+{
+	m_fullScan = true;
+	flush();
+}
+
+void DirectoryWatcher::schedule()
+{
+	// the window starts with the first change, the rest just joins it
+	if (!m_timer.isActive())
+	{
+		m_timer.start();
+	}
+}
+
+void DirectoryWatcher::directoryChanged(const QString &path)
+{
+	// a change above the folder, or the folder itself is gone
+	if (path != m_dir.absolutePath() || !QFileInfo(path).isDir())
+	{
+		rearm();
+	}
+	m_fullScan = true;
+	schedule();
+}
+
+bool DirectoryWatcher::stampEntry(const QFileInfo &entry, Stamp &out) const
+{
+	if (!entry.exists())
+	{
+		return false;
+	}
+	if ((m_filters & QDir::NoSymLinks) && entry.isSymLink())
+	{
+		return false;
+	}
+	if (!(m_filters & QDir::Hidden) && entry.isHidden())
+	{
+		return false;
+	}
+	if ((m_filters & QDir::Readable) && !entry.isReadable())
+	{
+		return false;
+	}
+	out.isDir = entry.isDir();
+	if (out.isDir ? !(m_filters & QDir::Dirs) : !(m_filters & QDir::Files))
+	{
+		return false;
+	}
+	out.size = out.isDir ? 0 : entry.size();
+	out.timestamp = entry.lastModified().toMSecsSinceEpoch();
+	return true;
+}
+
+QHash<QString, DirectoryWatcher::Stamp> DirectoryWatcher::snapshot() const
+{
+	QHash<QString, Stamp> out;
+	QDir dir(m_dir.absolutePath());
+	dir.setFilter(m_filters);
+	for (auto &entry : dir.entryInfoList())
+	{
+		Stamp stamp;
+		if (stampEntry(entry, stamp))
+		{
+			out.insert(entry.fileName(), stamp);
+		}
+	}
+	return out;
+}
+
+void DirectoryWatcher::flush()
+{
+	m_timer.stop();
+	Changes changes;
+	if (m_fullScan)
+	{
+		auto current = snapshot();
+		for (auto iter = current.begin(); iter != current.end(); iter++)
+		{
+			auto old = m_snapshot.constFind(iter.key());
+			if (old == m_snapshot.constEnd())
+			{
+				changes.added.append(iter.key());
+			}
+			else if (old.value() != iter.value())
+			{
+				changes.changed.append(iter.key());
+			}
+		}
+		for (auto iter = m_snapshot.begin(); iter != m_snapshot.end(); iter++)
+		{
+			if (!current.contains(iter.key()))
+			{
+				changes.removed.append(iter.key());
+			}
+		}
+		m_snapshot.swap(current);
+	}
+	else
+	{
+		// only look at what inotify told us about
+		for (auto &name : m_touched)
+		{
+			Stamp stamp;
+			bool present = stampEntry(QFileInfo(m_dir.absoluteFilePath(name)), stamp);
+			auto old = m_snapshot.find(name);
+			bool wasPresent = old != m_snapshot.end();
+			if (present && !wasPresent)
+			{
+				changes.added.append(name);
+				m_snapshot.insert(name, stamp);
+			}
+			else if (!present && wasPresent)
+			{
+				changes.removed.append(name);
+				m_snapshot.erase(old);
+			}
+			else if (present && old.value() != stamp)
+			{
+				changes.changed.append(name);
+				old.value() = stamp;
+			}
+		}
+	}
+	m_touched.clear();
+	m_fullScan = false;
+	if (!changes.isEmpty())
+	{
+		emit changed(changes);
+	}
+}
+
+#if defined Q_OS_LINUX
+bool DirectoryWatcher::startInotify()
+{
+	m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_inotifyFd < 0)
+	{
+		return false;
+	}
+	const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB |
+						  IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+	if (inotify_add_watch(m_inotifyFd, QFile::encodeName(m_dir.absolutePath()).constData(), mask) < 0)
+	{
+		::close(m_inotifyFd);
+		m_inotifyFd = -1;
+		return false;
+	}
+	m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+	connect(m_notifier, &QSocketNotifier::activated, this, &DirectoryWatcher::inotifyActivated);
+	return true;
+}
+
+void DirectoryWatcher::stopInotify()
+{
+	if (m_inotifyFd < 0)
+	{
+		return;
+	}
+	// this can happen while the notifier is telling us about the last events
+	m_notifier->setEnabled(false);
+	m_notifier->deleteLater();
+	m_notifier = nullptr;
+	::close(m_inotifyFd);
+	m_inotifyFd = -1;
+}
+
+void DirectoryWatcher::inotifyActivated()
+{
+	alignas(struct inotify_event) char buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+	ssize_t length;
+	bool lost = false;
+	while ((length = ::read(m_inotifyFd, buffer, sizeof(buffer))) > 0)
+	{
+		for (char *pos = buffer; pos < buffer + length;)
+		{
+			auto event = reinterpret_cast<struct inotify_event *>(pos);
+			if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+			{
+				// the watch went with the folder
+				lost = true;
+				m_fullScan = true;
+			}
+			else if (event->mask & IN_Q_OVERFLOW)
+			{
+				m_fullScan = true;
+			}
+			else if (event->len)
+			{
+				m_touched.insert(QFile::decodeName(event->name));
+			}
+			pos += sizeof(struct inotify_event) + event->len;
+		}
+	}
+	if (lost)
+	{
+		rearm();
+	}
+	schedule();
+}
+#else
+bool DirectoryWatcher::startInotify()
+{
+	return false;
+}
+
+void DirectoryWatcher::stopInotify()
+{
+}
+
+void DirectoryWatcher::inotifyActivated()
+{
+}
+#endif
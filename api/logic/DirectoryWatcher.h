@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QObject>
+#include <QDir>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+#include "multimc_logic_export.h"
+
+class QFileSystemWatcher;
+class QSocketNotifier;
+
+/**
+ * Watches the entries of a single folder and reports what changed in it.
+ *
+ * Notifications are coalesced over a short window and the folder is compared with the previous snapshot,
+ * by name, size and timestamp, so a burst of changes results in a single report listing
+ * the entries that were added, removed and changed.
+ *
+ * On Linux, inotify is used directly: it says which entries were touched, so only those are looked at again.
+ * Elsewhere, QFileSystemWatcher is used and the whole folder is listed again.
+ *
+ * If the folder is removed or moved away, the closest folder above it is watched until it's back.
+ */
+class MULTIMC_LOGIC_EXPORT DirectoryWatcher : public QObject
+{
+	Q_OBJECT
+public:
+	/// Names of entries, relative to the folder
+	struct Changes
+	{
+		QStringList added;
+		QStringList removed;
+		QStringList changed;
+		bool isEmpty() const
+		{
+			return added.isEmpty() && removed.isEmpty() && changed.isEmpty();
+		}
+	};
+
+	explicit DirectoryWatcher(QObject *parent = nullptr);
+	virtual ~DirectoryWatcher();
+
+	/// The folder to watch. Changing it while watching starts over with the new folder.
+	void setDirectory(const QString &path);
+	QString directory() const
+	{
+		return m_dir.absolutePath();
+	}
+
+	/// What kind of entries are of interest, as in QDir::setFilter. Defaults to files and folders.
+	void setFilter(QDir::Filters filters);
+
+	/// How long to wait for more changes before reporting them, in milliseconds
+	void setDelay(int msecs);
+
+	/// Take a snapshot of the folder and start watching it. Returns false if the folder can't be watched.
+	bool start();
+	void stop();
+	bool isWatching() const
+	{
+		return m_watching;
+	}
+
+	/// Look at the whole folder again now and report any changes, for example after changing it ourselves
+	void rescan();
+
+	/// The entries of the folder, as of the last report
+	QStringList entries() const
+	{
+		return m_snapshot.keys();
+	}
+
+signals:
+	void changed(const DirectoryWatcher::Changes &changes);
+
+private slots:
+	void directoryChanged(const QString &path);
+	void inotifyActivated();
+	void flush();
+
+private:
+	struct Stamp
+	{
+		qint64 size = 0;
+		qint64 timestamp = 0;
+		bool isDir = false;
+		bool operator==(const Stamp &other) const
+		{
+			return size == other.size && timestamp == other.timestamp && isDir == other.isDir;
+		}
+		bool operator!=(const Stamp &other) const
+		{
+			return !(*this == other);
+		}
+	};
+	bool stampEntry(const QFileInfo &entry, Stamp &out) const;
+	QHash<QString, Stamp> snapshot() const;
+	void schedule();
+	bool arm();
+	void rearm();
+	bool startInotify();
+	void stopInotify();
+
+private:
+	QDir m_dir;
+	QDir::Filters m_filters = QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable | QDir::NoSymLinks;
+	bool m_watching = false;
+	QHash<QString, Stamp> m_snapshot;
+	QTimer m_timer;
+
+	QFileSystemWatcher *m_watcher = nullptr;
+
+	int m_inotifyFd = -1;
+	QSocketNotifier *m_notifier = nullptr;
+	/// entries inotify told us about since the last report
+	QSet<QString> m_touched;
+	/// set when we don't know what changed and have to look at everything
+	bool m_fullScan = false;
+};
@@ -1,5 +1,6 @@
 #include "Env.h"
 #include "net/HttpMetaCache.h"
+#include "net/HostScheduler.h"
 #include "BaseVersion.h"
 #include "BaseVersionList.h"
 #include <QDir>
@@ -16,6 +17,7 @@
 struct Env::Private
 {
 	QNetworkAccessManager m_qnam;
+	Net::HostScheduler m_hostScheduler;
 	shared_qobject_ptr<HttpMetaCache> m_metacache;
 	std::shared_ptr<IIconList> m_iconlist;
 	shared_qobject_ptr<Meta::Index> m_metadataIndex;
@@ -63,6 +65,11 @@ QNetworkAccessManager& Env::qnam() const
 	return d->m_qnam;
 }
 
+Net::HostScheduler& Env::hostScheduler() const
+{
+	return d->m_hostScheduler;
+}
+
 std::shared_ptr<IIconList> Env::icons()
 {
 	return d->m_iconlist;
@@ -11,6 +11,10 @@
 
 class QNetworkAccessManager;
 class HttpMetaCache;
+namespace Net
+{
+class HostScheduler;
+}
 class BaseVersionList;
 class BaseVersion;
 
@@ -38,6 +42,9 @@ public:
 
 	QNetworkAccessManager &qnam() const;
 
+	/// Limits on concurrent downloads, shared by all NetJobs
+	Net::HostScheduler &hostScheduler() const;
+
 	shared_qobject_ptr<HttpMetaCache> metacache();
 
 	std::shared_ptr<IIconList> icons();
@@ -8,6 +8,18 @@
 #include <QDebug>
 #include <QUrl>
 #include <QStandardPaths>
+#include <QtConcurrentMap>
+#include <atomic>
+
+#if defined Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#include <fcntl.h>
+#endif
+#if defined Q_OS_UNIX
+#include <unistd.h>
+#endif
 
 namespace FS {
 
@@ -60,6 +72,27 @@ QByteArray read(const QString &filename)
 	return data;
 }
 
+QByteArray hashFile(const QString &filename, QCryptographicHash::Algorithm algorithm)
+{
+	QFile input(filename);
+	if (!input.open(QIODevice::ReadOnly))
+	{
+		return QByteArray();
+	}
+	QCryptographicHash hash(algorithm);
+	QByteArray buffer(256 * 1024, Qt::Uninitialized);
+	qint64 read;
+	while ((read = input.read(buffer.data(), buffer.size())) > 0)
+	{
+		hash.addData(buffer.constData(), int(read));
+	}
+	if (read < 0)
+	{
+		return QByteArray();
+	}
+	return hash.result();
+}
+
 bool updateTimestamp(const QString& filename)
 {
 	QFile file(filename);
@@ -97,13 +130,71 @@ bool ensureFolderPathExists(QString foldernamepath)
 	return success;
 }
 
-bool copy::operator()(const QString &offset)
+bool copy::operator()()
 {
 	//NOTE always deep copy on windows. the alternatives are too messy.
 	#if defined Q_OS_WIN32
 	m_followSymlinks = true;
 	#endif
 
+	// folders and symlinks are made while walking the tree, files are copied afterwards
+	QList<FileEntry> files;
+	if (!gather(QString(), files))
+	{
+		return false;
+	}
+
+	qint64 total = 0;
+	for (auto &file : files)
+	{
+		total += file.size;
+	}
+	if (m_progress)
+	{
+		m_progress(0, total);
+	}
+
+	std::atomic<qint64> done(0);
+	std::atomic<bool> failed(false);
+	auto copyOne = [&](const FileEntry &file)
+	{
+		if (failed || aborted())
+		{
+			return;
+		}
+		if (!copyFile(file))
+		{
+			qWarning() << "Failed to copy" << file.offset;
+			failed = true;
+			return;
+		}
+		qint64 count = done.fetch_add(file.size) + file.size;
+		if (m_progress)
+		{
+			m_progress(count, total);
+		}
+	};
+	if (m_parallel)
+	{
+		QtConcurrent::blockingMap(files, copyOne);
+	}
+	else
+	{
+		for (auto &file : files)
+		{
+			copyOne(file);
+		}
+	}
+	return !failed && !aborted();
+}
+
+bool copy::gather(const QString &offset, QList<FileEntry> &files)
+{
+	if (aborted())
+	{
+		return false;
+	}
+
 	auto src = PathCombine(m_src.absolutePath(), offset);
 	auto dst = PathCombine(m_dst.absolutePath(), offset);
 
@@ -123,13 +214,7 @@ bool copy::operator()(const QString &offset)
 	}
 	else if(currentSrc.isFile())
 	{
-		qDebug() << "copying file" << src << " - " << dst;
-		if (!ensureFilePathExists(dst))
-		{
-			qWarning() << "Cannot create path!";
-			return false;
-		}
-		return QFile::copy(src, dst);
+		files.append({src, dst, offset, currentSrc.size()});
 	}
 	else if(currentSrc.isDir())
 	{
@@ -148,7 +233,7 @@ bool copy::operator()(const QString &offset)
 			{
 				continue;
 			}
-			if(!operator()(inner_offset))
+			if(!gather(inner_offset, files))
 			{
 				qWarning() << "Failed to copy" << inner_offset;
 				return false;
@@ -163,11 +248,110 @@ bool copy::operator()(const QString &offset)
 	return true;
 }
 
+bool copy::copyFile(const FileEntry &file)
+{
+	qDebug() << "copying file" << file.src << " - " << file.dst;
+	if (m_hardlink && m_hardlink->matches(file.offset))
+	{
+		return cloneFile(file.src, file.dst, true) != CloneMethod::Failed;
+	}
+	if (m_cloneFiles)
+	{
+		return cloneFile(file.src, file.dst, false) != CloneMethod::Failed;
+	}
+	if (!ensureFilePathExists(file.dst))
+	{
+		qWarning() << "Cannot create path!";
+		return false;
+	}
+	return QFile::copy(file.src, file.dst);
+}
+
 
 #if defined Q_OS_WIN32
 #include <windows.h>
 #include <string>
 #endif
+
+static bool reflinkFile(const QString &src, const QString &dst)
+{
+#if defined Q_OS_LINUX && defined FICLONE
+	int srcFd = ::open(QFile::encodeName(src).constData(), O_RDONLY);
+	if (srcFd < 0)
+	{
+		return false;
+	}
+	struct stat srcStat;
+	if (::fstat(srcFd, &srcStat) != 0)
+	{
+		::close(srcFd);
+		return false;
+	}
+	auto dstName = QFile::encodeName(dst);
+	int dstFd = ::open(dstName.constData(), O_WRONLY | O_CREAT | O_EXCL, 0600);
+	if (dstFd < 0)
+	{
+		::close(srcFd);
+		return false;
+	}
+	// keep the permissions of the source, like QFile::copy does
+	bool cloned = ::ioctl(dstFd, FICLONE, srcFd) == 0 && ::fchmod(dstFd, srcStat.st_mode & 07777) == 0;
+	::close(dstFd);
+	::close(srcFd);
+	if (!cloned)
+	{
+		::unlink(dstName.constData());
+	}
+	return cloned;
+#else
+	Q_UNUSED(src);
+	Q_UNUSED(dst);
+	return false;
+#endif
+}
+
+static bool hardlinkFile(const QString &src, const QString &dst)
+{
+#if defined Q_OS_WIN32
+	auto srcString = QDir::toNativeSeparators(src).toStdWString();
+	auto dstString = QDir::toNativeSeparators(dst).toStdWString();
+	return CreateHardLinkW(dstString.c_str(), srcString.c_str(), NULL);
+#elif defined Q_OS_UNIX
+	return ::link(QFile::encodeName(src).constData(), QFile::encodeName(dst).constData()) == 0;
+#else
+	Q_UNUSED(src);
+	Q_UNUSED(dst);
+	return false;
+#endif
+}
+
+CloneMethod cloneFile(const QString &src, const QString &dst, bool allowHardlink)
+{
+	if (!ensureFilePathExists(dst))
+	{
+		qWarning() << "Cannot create path for" << dst;
+		return CloneMethod::Failed;
+	}
+	if (QFileInfo(dst).exists() && !QFile::remove(dst))
+	{
+		qWarning() << "Cannot replace" << dst;
+		return CloneMethod::Failed;
+	}
+	if (reflinkFile(src, dst))
+	{
+		return CloneMethod::Reflink;
+	}
+	if (allowHardlink && hardlinkFile(src, dst))
+	{
+		return CloneMethod::Hardlink;
+	}
+	if (QFile::copy(src, dst))
+	{
+		return CloneMethod::Copy;
+	}
+	return CloneMethod::Failed;
+}
+
 bool deletePath(QString path)
 {
 	bool OK = true;
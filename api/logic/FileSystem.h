@@ -8,6 +8,9 @@
 #include "multimc_logic_export.h"
 #include <QDir>
 #include <QFlags>
+#include <QCryptographicHash>
+#include <QAtomicInt>
+#include <functional>
 
 namespace FS
 {
@@ -28,6 +31,12 @@ MULTIMC_LOGIC_EXPORT void write(const QString &filename, const QByteArray &data)
  */
 MULTIMC_LOGIC_EXPORT QByteArray read(const QString &filename);
 
+/**
+ * hash the contents of a file, a chunk at a time
+ * returns the raw hash, or an empty array if the file can't be read
+ */
+MULTIMC_LOGIC_EXPORT QByteArray hashFile(const QString &filename, QCryptographicHash::Algorithm algorithm);
+
 /**
  * Update the last changed timestamp of an existing file
  */
@@ -63,21 +72,96 @@ public:
 		m_blacklist = filter;
 		return *this;
 	}
-	bool operator()()
+	/**
+	 * Try to make copy-on-write clones (reflinks) of files before copying their contents.
+	 * Existing files in the destination are replaced.
+	 */
+	copy & cloneFiles(const bool clone)
+	{
+		m_cloneFiles = clone;
+		return *this;
+	}
+	/**
+	 * Files matching the filter are hard linked when they can't be cloned.
+	 * Only use this for files nobody modifies in place (mod jars, libraries).
+	 */
+	copy & hardlink(const IPathMatcher * filter)
+	{
+		m_hardlink = filter;
+		return *this;
+	}
+	/**
+	 * Copy the files on several threads of the global thread pool.
+	 */
+	copy & parallel(const bool parallel)
+	{
+		m_parallel = parallel;
+		return *this;
+	}
+	/**
+	 * Report progress in bytes done and bytes total.
+	 * With parallel copying, this is called from several threads at once.
+	 */
+	copy & progress(std::function<void(qint64, qint64)> callback)
+	{
+		m_progress = callback;
+		return *this;
+	}
+	/**
+	 * Stop copying when the flag is set to anything but 0.
+	 */
+	copy & abortFlag(const QAtomicInt * flag)
 	{
-		return operator()(QString());
+		m_abortFlag = flag;
+		return *this;
 	}
+	bool operator()();
 
 private:
-	bool operator()(const QString &offset);
+	struct FileEntry
+	{
+		QString src;
+		QString dst;
+		QString offset;
+		qint64 size;
+	};
+	bool gather(const QString &offset, QList<FileEntry> &files);
+	bool copyFile(const FileEntry &file);
+	bool aborted() const
+	{
+		return m_abortFlag && m_abortFlag->loadAcquire();
+	}
 
 private:
 	bool m_followSymlinks = true;
+	bool m_cloneFiles = false;
+	bool m_parallel = false;
 	const IPathMatcher * m_blacklist = nullptr;
+	const IPathMatcher * m_hardlink = nullptr;
+	const QAtomicInt * m_abortFlag = nullptr;
+	std::function<void(qint64, qint64)> m_progress;
 	QDir m_src;
 	QDir m_dst;
 };
 
+enum class CloneMethod
+{
+	Failed,
+	Reflink,
+	Hardlink,
+	Copy
+};
+
+/**
+ * Make dst a file with the same contents as src, in the cheapest way available:
+ * a copy-on-write clone (reflink) where the file system supports it, then a hard link
+ * (unless allowHardlink is false), and a full copy as the last resort.
+ *
+ * Hard links share the file with src - only use them for files nobody modifies in place.
+ * An existing dst is replaced.
+ */
+MULTIMC_LOGIC_EXPORT CloneMethod cloneFile(const QString &src, const QString &dst, bool allowHardlink = true);
+
 /**
  * Delete a folder recursively
  */
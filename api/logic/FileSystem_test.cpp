@@ -4,6 +4,35 @@
 #include "TestUtil.h"
 
 #include "FileSystem.h"
+#include "pathmatcher/RegexpMatcher.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <algorithm>
+
+#if defined Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+// whether both paths lead to the same file on disk
+bool sameFile(const QString &a, const QString &b)
+{
+#if defined Q_OS_UNIX
+	struct stat statA;
+	struct stat statB;
+	if (::stat(QFile::encodeName(a).constData(), &statA) != 0 || ::stat(QFile::encodeName(b).constData(), &statB) != 0)
+	{
+		return false;
+	}
+	return statA.st_dev == statB.st_dev && statA.st_ino == statB.st_ino;
+#else
+	Q_UNUSED(a);
+	Q_UNUSED(b);
+	return false;
+#endif
+}
+}
 
 class FileSystemTest : public QObject
 {
@@ -112,6 +141,121 @@ slots:
 		f();
 	}
 
+	void test_copyParallel()
+	{
+		QTemporaryDir tempDir;
+		tempDir.setAutoRemove(true);
+		QString from = FS::PathCombine(tempDir.path(), "from");
+		QString to = FS::PathCombine(tempDir.path(), "to");
+		const int files = 200;
+		qint64 size = 0;
+		for(int i = 0; i < files; i++)
+		{
+			auto data = QByteArray::number(i).repeated(i + 1);
+			size += data.size();
+			FS::write(FS::PathCombine(from, QString("folder%1").arg(i % 7), QString("file%1.txt").arg(i)), data);
+		}
+		FS::write(FS::PathCombine(from, "mods", "mod.jar"), "jar");
+		size += 3;
+#if defined Q_OS_UNIX
+		auto scriptFrom = FS::PathCombine(from, "folder1", "file1.txt");
+		auto readOnlyFrom = FS::PathCombine(from, "folder2", "file2.txt");
+		auto scriptPermissions = QFile::permissions(scriptFrom) | QFileDevice::ExeOwner | QFileDevice::ExeUser;
+		auto readOnlyPermissions = QFileDevice::ReadOwner | QFileDevice::ReadUser | QFileDevice::ReadGroup;
+		QVERIFY(QFile::setPermissions(scriptFrom, scriptPermissions));
+		QVERIFY(QFile::setPermissions(readOnlyFrom, readOnlyPermissions));
+#endif
+
+		RegexpMatcher jars("^mods/.*[.]jar$");
+		qint64 lastDone = 0;
+		qint64 lastTotal = 0;
+		QMutex progressLock;
+		FS::copy c(from, to);
+		c.cloneFiles(true).hardlink(&jars).parallel(true).progress([&](qint64 done, qint64 total)
+		{
+			QMutexLocker locker(&progressLock);
+			lastDone = std::max(lastDone, done);
+			lastTotal = total;
+		});
+		QVERIFY(c());
+		QCOMPARE(lastTotal, size);
+		QCOMPARE(lastDone, size);
+		for(int i = 0; i < files; i++)
+		{
+			auto path = FS::PathCombine(to, QString("folder%1").arg(i % 7), QString("file%1.txt").arg(i));
+			QCOMPARE(FS::read(path), QByteArray::number(i).repeated(i + 1));
+		}
+		QCOMPARE(FS::read(FS::PathCombine(to, "mods", "mod.jar")), QByteArray("jar"));
+#if defined Q_OS_UNIX
+		// clones keep the permissions, like copies do
+		QCOMPARE(QFile::permissions(FS::PathCombine(to, "folder1", "file1.txt")), scriptPermissions);
+		QCOMPARE(QFile::permissions(FS::PathCombine(to, "folder2", "file2.txt")), readOnlyPermissions);
+#endif
+
+		// cloned files are not shared with the original, even when written to in place
+		QFile copied(FS::PathCombine(to, "folder0", "file0.txt"));
+		QVERIFY(copied.open(QIODevice::ReadWrite));
+		QCOMPARE(copied.write("X"), qint64(1));
+		copied.close();
+		QCOMPARE(FS::read(copied.fileName()), QByteArray("X"));
+		QCOMPARE(FS::read(FS::PathCombine(from, "folder0", "file0.txt")), QByteArray("0"));
+		QVERIFY(!sameFile(copied.fileName(), FS::PathCombine(from, "folder0", "file0.txt")));
+
+#if defined Q_OS_UNIX
+		// the jar is a hard link, unless the file system could clone it
+		auto jarFrom = FS::PathCombine(from, "mods", "mod.jar");
+		auto jarTo = FS::PathCombine(to, "mods", "mod.jar");
+		if (!sameFile(jarFrom, jarTo))
+		{
+			QCOMPARE(FS::cloneFile(jarFrom, FS::PathCombine(tempDir.path(), "probe"), false), FS::CloneMethod::Reflink);
+		}
+#endif
+	}
+
+	void test_copyAbort()
+	{
+		QTemporaryDir tempDir;
+		tempDir.setAutoRemove(true);
+		QString from = FS::PathCombine(tempDir.path(), "from");
+		FS::write(FS::PathCombine(from, "file.txt"), "contents");
+		QAtomicInt aborted(1);
+		FS::copy c(from, FS::PathCombine(tempDir.path(), "to"));
+		c.abortFlag(&aborted);
+		QVERIFY(!c());
+		QVERIFY(!QFile::exists(FS::PathCombine(tempDir.path(), "to", "file.txt")));
+	}
+
+	void test_cloneFile()
+	{
+		QTemporaryDir tempDir;
+		tempDir.setAutoRemove(true);
+		QString src = FS::PathCombine(tempDir.path(), "source");
+		QString dst = FS::PathCombine(tempDir.path(), "some/folder/target");
+		FS::write(src, "contents");
+		FS::write(FS::PathCombine(tempDir.path(), "some/folder/target"), "old contents");
+
+		QVERIFY(FS::cloneFile(src, dst) != FS::CloneMethod::Failed);
+		QCOMPARE(FS::read(dst), QByteArray("contents"));
+
+		// without hard links, changing the target can't change the source
+		QVERIFY(FS::cloneFile(src, dst, false) != FS::CloneMethod::Hardlink);
+		FS::write(dst, "changed");
+		QCOMPARE(FS::read(src), QByteArray("contents"));
+	}
+
+	void test_hashFile()
+	{
+		QTemporaryDir tempDir;
+		tempDir.setAutoRemove(true);
+		QString path = FS::PathCombine(tempDir.path(), "file");
+		// bigger than one chunk
+		auto data = QByteArray("0123456789abcdef").repeated(20000);
+		FS::write(path, data);
+		QCOMPARE(FS::hashFile(path, QCryptographicHash::Sha1), QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+		QCOMPARE(FS::hashFile(path, QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5));
+		QVERIFY(FS::hashFile(FS::PathCombine(tempDir.path(), "missing"), QCryptographicHash::Sha1).isEmpty());
+	}
+
 	void test_getDesktop()
 	{
 		QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation));
@@ -13,9 +13,35 @@
 #include <QJsonArray>
 #include <QUuid>
 #include <QTimer>
+#include <QtConcurrentMap>
+#include <QDataStream>
+#include <QSaveFile>
 
 const static int GROUP_FILE_FORMAT_VERSION = 1;
 
+namespace {
+const QString SNAPSHOT_MAGIC = "MultiMC instance snapshot";
+const qint32 SNAPSHOT_FORMAT_VERSION = 1;
+
+// size and modification time of a file, -1 if it doesn't exist
+QPair<qint64, qint64> signatureOf(const QString & path)
+{
+	QFileInfo info(path);
+	if(!info.exists())
+	{
+		return qMakePair(qint64(-1), qint64(-1));
+	}
+	return qMakePair(info.size(), info.lastModified().toMSecsSinceEpoch());
+}
+
+struct FolderInstancePrefetch : public InstancePrefetch
+{
+	INIFile config;
+	// of instance.cfg, taken before reading it
+	QPair<qint64, qint64> signature;
+};
+}
+
 struct WatchLock
 {
 	WatchLock(QFileSystemWatcher * watcher, const QString& instDir)
@@ -46,33 +72,88 @@ FolderInstanceProvider::FolderInstanceProvider(SettingsObjectPtr settings, const
 
 QList< InstanceId > FolderInstanceProvider::discoverInstances()
 {
-	QList<InstanceId> out;
+	QStringList subDirs;
 	QDirIterator iter(m_instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable, QDirIterator::FollowSymlinks);
 	while (iter.hasNext())
 	{
-		QString subDir = iter.next();
+		subDirs.append(iter.next());
+	}
+	// checking the folders is all file system access, so do it in parallel
+	QFileInfo instDirInfo(m_instDir);
+	using Found = QPair<InstanceId, QPair<qint64, qint64>>;
+	std::function<Found(const QString &)> check = [instDirInfo](const QString & subDir) -> Found
+	{
 		QFileInfo dirInfo(subDir);
-		if (!QFileInfo(FS::PathCombine(subDir, "instance.cfg")).exists())
-			continue;
+		auto signature = signatureOf(FS::PathCombine(subDir, "instance.cfg"));
+		if (signature.first == -1)
+			return Found();
 		// if it is a symlink, ignore it if it goes to the instance folder
 		if(dirInfo.isSymLink())
 		{
 			QFileInfo targetInfo(dirInfo.symLinkTarget());
-			QFileInfo instDirInfo(m_instDir);
 			if(targetInfo.canonicalPath() == instDirInfo.canonicalFilePath())
 			{
 				qDebug() << "Ignoring symlink" << subDir << "that leads into the instances folder";
-				continue;
+				return Found();
 			}
 		}
-		auto id = dirInfo.fileName();
-		out.append(id);
-		qDebug() << "Found instance ID" << id;
+		return qMakePair(dirInfo.fileName(), signature);
+	};
+	auto found = QtConcurrent::blockingMapped<QList<Found>>(subDirs, check);
+
+	QList<InstanceId> out;
+	m_found.clear();
+	for(auto & instance: found)
+	{
+		if(instance.first.isEmpty())
+			continue;
+		out.append(instance.first);
+		m_found.insert(instance.first, instance.second);
 	}
+
+	// forget what is gone, and check the instances created from the snapshot
+	for(auto iter = m_snapshot.begin(); iter != m_snapshot.end();)
+	{
+		if(!m_found.contains(iter.key()))
+		{
+			m_fromSnapshot.remove(iter.key());
+			iter = m_snapshot.erase(iter);
+			m_snapshotChanged = true;
+			continue;
+		}
+		if(m_fromSnapshot.contains(iter.key()))
+		{
+			auto prefetch = std::static_pointer_cast<FolderInstancePrefetch>(iter.value());
+			if(prefetch->signature == m_found[iter.key()])
+			{
+				m_fromSnapshot.remove(iter.key());
+			}
+		}
+		iter++;
+	}
+	qDebug() << "Found" << out.size() << "instances in" << m_instDir;
 	return out;
 }
 
+InstancePrefetcher FolderInstanceProvider::prefetcher()
+{
+	auto instDir = m_instDir;
+	return [instDir](const InstanceId & id) -> InstancePrefetchPtr
+	{
+		auto prefetch = std::make_shared<FolderInstancePrefetch>();
+		auto configPath = FS::PathCombine(instDir, id, "instance.cfg");
+		prefetch->signature = signatureOf(configPath);
+		prefetch->config.loadFile(configPath);
+		return prefetch;
+	};
+}
+
 InstancePtr FolderInstanceProvider::loadInstance(const InstanceId& id)
+{
+	return loadInstance(id, nullptr);
+}
+
+InstancePtr FolderInstanceProvider::loadInstance(const InstanceId& id, const InstancePrefetchPtr &prefetch)
 {
 	if(!m_groupsLoaded)
 	{
@@ -80,7 +161,24 @@ InstancePtr FolderInstanceProvider::loadInstance(const InstanceId& id)
 	}
 
 	auto instanceRoot = FS::PathCombine(m_instDir, id);
-	auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
+	auto configPath = FS::PathCombine(instanceRoot, "instance.cfg");
+	std::shared_ptr<INISettingsObject> instanceSettings;
+	auto folderPrefetch = std::dynamic_pointer_cast<FolderInstancePrefetch>(prefetch);
+	if(folderPrefetch)
+	{
+		instanceSettings = std::make_shared<INISettingsObject>(configPath, folderPrefetch->config);
+		// remember what was read from the disk for the snapshot
+		if(m_snapshot.value(id) != prefetch)
+		{
+			m_snapshot[id] = prefetch;
+			m_fromSnapshot.remove(id);
+			m_snapshotChanged = true;
+		}
+	}
+	else
+	{
+		instanceSettings = std::make_shared<INISettingsObject>(configPath);
+	}
 	InstancePtr inst;
 
 	instanceSettings->registerSetting("InstanceType", "Legacy");
@@ -107,10 +205,90 @@ InstancePtr FolderInstanceProvider::loadInstance(const InstanceId& id)
 		inst->setGroupInitial((*iter));
 	}
 	connect(inst.get(), &BaseInstance::groupChanged, this, &FolderInstanceProvider::groupChanged);
-	qDebug() << "Loaded instance " << inst->name() << " from " << inst->instanceRoot();
 	return inst;
 }
 
+QString FolderInstanceProvider::snapshotPath() const
+{
+	return FS::PathCombine(m_instDir, "instances.snapshot");
+}
+
+QMap<InstanceId, InstancePrefetchPtr> FolderInstanceProvider::snapshot()
+{
+	m_snapshot.clear();
+	m_fromSnapshot.clear();
+	m_snapshotChanged = false;
+
+	QFile file(snapshotPath());
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		return {};
+	}
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	QString magic;
+	qint32 version;
+	qint32 count;
+	in >> magic >> version >> count;
+	if(magic != SNAPSHOT_MAGIC || version != SNAPSHOT_FORMAT_VERSION)
+	{
+		return {};
+	}
+	QMap<InstanceId, InstancePrefetchPtr> snapshot;
+	for(int i = 0; i < count && in.status() == QDataStream::Ok; i++)
+	{
+		InstanceId id;
+		auto prefetch = std::make_shared<FolderInstancePrefetch>();
+		in >> id >> prefetch->signature.first >> prefetch->signature.second
+			>> static_cast<QMap<QString, QVariant> &>(prefetch->config);
+		snapshot.insert(id, prefetch);
+	}
+	if(in.status() != QDataStream::Ok)
+	{
+		qWarning() << "Ignoring damaged instance snapshot" << file.fileName();
+		return {};
+	}
+	m_snapshot = snapshot;
+	m_fromSnapshot = snapshot.keys().toSet();
+	qDebug() << "Loaded" << snapshot.size() << "instances from the snapshot";
+	return snapshot;
+}
+
+bool FolderInstanceProvider::isStale(const InstanceId& id)
+{
+	return m_fromSnapshot.contains(id);
+}
+
+void FolderInstanceProvider::saveSnapshot()
+{
+	if(!m_snapshotChanged)
+	{
+		return;
+	}
+	WatchLock foo(m_watcher, m_instDir);
+	QSaveFile file(snapshotPath());
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		qWarning() << "Failed to write the instance snapshot:" << file.errorString();
+		return;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << SNAPSHOT_MAGIC << SNAPSHOT_FORMAT_VERSION << qint32(m_snapshot.size());
+	for(auto iter = m_snapshot.begin(); iter != m_snapshot.end(); iter++)
+	{
+		auto prefetch = std::static_pointer_cast<FolderInstancePrefetch>(iter.value());
+		out << iter.key() << prefetch->signature.first << prefetch->signature.second
+			<< static_cast<const QMap<QString, QVariant> &>(prefetch->config);
+	}
+	if(!file.commit())
+	{
+		qWarning() << "Failed to write the instance snapshot:" << file.errorString();
+		return;
+	}
+	m_snapshotChanged = false;
+}
+
 void FolderInstanceProvider::saveGroupList()
 {
 	WatchLock foo(m_watcher, m_instDir);
@@ -288,6 +466,10 @@ void FolderInstanceProvider::on_InstFolderChanged(const Setting &setting, QVaria
 		{
 			saveGroupList();
 		}
+		saveSnapshot();
+		m_snapshot.clear();
+		m_fromSnapshot.clear();
+		m_found.clear();
 		m_instDir = newInstDir;
 		m_groupsLoaded = false;
 		emit instancesChanged();
@@ -366,6 +548,17 @@ public:
 		connect(&m_backoffTimer, &QTimer::timeout, this, &FolderInstanceStaging::childSucceded);
 	}
 
+	bool canAbort() const override
+	{
+		return m_child->canAbort();
+	}
+
+public slots:
+	bool abort() override
+	{
+		return m_child->abort();
+	}
+
 protected:
 	virtual void executeTask() override
 	{
@@ -2,6 +2,8 @@
 
 #include "BaseInstanceProvider.h"
 #include <QMap>
+#include <QPair>
+#include <QSet>
 
 class QFileSystemWatcher;
 
@@ -18,6 +20,19 @@ public:
 	/// used by InstanceList to (re)load an instance with the given @id.
 	InstancePtr loadInstance(const InstanceId& id) override;
 
+	/// used by InstanceList to read instance.cfg files on worker threads
+	InstancePrefetcher prefetcher() override;
+
+	/// used by InstanceList to load an instance with the given @id, from a prefetched instance.cfg
+	InstancePtr loadInstance(const InstanceId& id, const InstancePrefetchPtr &prefetch) override;
+
+	/// used by InstanceList to create instances from the instance.cfg files remembered last time
+	QMap<InstanceId, InstancePrefetchPtr> snapshot() override;
+	/// used by InstanceList to find instances created from the snapshot whose instance.cfg changed since
+	bool isStale(const InstanceId &id) override;
+	/// used by InstanceList to remember the instance.cfg files for next time
+	void saveSnapshot() override;
+
 
 	// create instance in this provider
 	Task * creationTask(BaseVersionPtr version, const QString &instName, const QString &instGroup, const QString &instIcon);
@@ -57,10 +72,19 @@ private slots:
 private: /* methods */
 	void loadGroupList() override;
 	void saveGroupList() override;
+	QString snapshotPath() const;
 
 private: /* data */
 	QString m_instDir;
 	QFileSystemWatcher * m_watcher;
 	QMap<QString, QString> groupMap;
 	bool m_groupsLoaded = false;
+
+	// the last known contents of each instance.cfg, with its size and modification time
+	QMap<InstanceId, InstancePrefetchPtr> m_snapshot;
+	// instances created from the snapshot that are not confirmed by discovery yet, or turned out to be out of date
+	QSet<InstanceId> m_fromSnapshot;
+	// size and modification time of each instance.cfg, as found by discovery
+	QMap<InstanceId, QPair<qint64, qint64>> m_found;
+	bool m_snapshotChanged = false;
 };
@@ -11,6 +11,16 @@ bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedByte
 	}
 
 	unsigned uncompLength = compressedBytes.size();
+	// the gzip trailer ends with the uncompressed size, start with that much room if it looks sane
+	if (compressedBytes.size() >= 18)
+	{
+		auto trailer = (const unsigned char *)compressedBytes.constData() + compressedBytes.size() - 4;
+		quint64 stored = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (quint64(trailer[3]) << 24);
+		if (stored > uncompLength && stored <= quint64(compressedBytes.size()) * 1032 && stored < (1u << 30))
+		{
+			uncompLength = stored;
+		}
+	}
 	uncompressedBytes.clear();
 	uncompressedBytes.resize(uncompLength);
 
@@ -22,6 +22,17 @@ InstanceCopyTask::InstanceCopyTask(SettingsObjectPtr settings, const QString & s
 		matcherReal->caseSensitive(false);
 		m_matcher.reset(matcherReal);
 	}
+	// nothing changes these in place, so the copy can share them with the original
+	auto hardlinkReal = new RegexpMatcher("^([.]?minecraft/(mods|coremods)/[^/]+[.](jar|zip|litemod)([.]disabled)?|libraries/.+|jarmods/.+)$");
+	hardlinkReal->caseSensitive(false);
+	m_hardlinkMatcher.reset(hardlinkReal);
+}
+
+InstanceCopyTask::~InstanceCopyTask()
+{
+	// the copy uses this object, do not let it outlive it
+	m_aborted.storeRelease(1);
+	m_copyFuture.waitForFinished();
 }
 
 void InstanceCopyTask::executeTask()
@@ -29,7 +40,11 @@ void InstanceCopyTask::executeTask()
 	setStatus(tr("Copying instance %1").arg(m_origInstance->name()));
 
 	FS::copy folderCopy(m_origInstance->instanceRoot(), m_stagingPath);
-	folderCopy.followSymlinks(false).blacklist(m_matcher.get());
+	folderCopy.followSymlinks(false).blacklist(m_matcher.get()).cloneFiles(true).hardlink(m_hardlinkMatcher.get()).parallel(true);
+	folderCopy.abortFlag(&m_aborted).progress([this](qint64 done, qint64 total)
+	{
+		reportProgress(done, total);
+	});
 
 	m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), folderCopy);
 	connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &InstanceCopyTask::copyFinished);
@@ -37,9 +52,20 @@ void InstanceCopyTask::executeTask()
 	m_copyFutureWatcher.setFuture(m_copyFuture);
 }
 
+bool InstanceCopyTask::abort()
+{
+	m_aborted.storeRelease(1);
+	return true;
+}
+
 void InstanceCopyTask::copyFinished()
 {
 	auto successful = m_copyFuture.result();
+	if(m_aborted.loadAcquire())
+	{
+		emitAborted();
+		return;
+	}
 	if(!successful)
 	{
 		emitFailed(tr("Instance folder copy failed."));
@@ -6,6 +6,7 @@
 #include <QUrl>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QAtomicInt>
 #include "settings/SettingsObject.h"
 #include "BaseVersion.h"
 #include "BaseInstance.h"
@@ -19,6 +20,15 @@ class MULTIMC_LOGIC_EXPORT InstanceCopyTask : public Task
 public:
 	explicit InstanceCopyTask(SettingsObjectPtr settings, const QString & stagingPath, InstancePtr origInstance, const QString &instName,
 		const QString &instIcon, const QString &instGroup, bool copySaves);
+	virtual ~InstanceCopyTask();
+
+	bool canAbort() const override
+	{
+		return true;
+	}
+
+public slots:
+	bool abort() override;
 
 protected:
 	//! Entry point for tasks.
@@ -36,6 +46,8 @@ private: /* data */
 	QFuture<bool> m_copyFuture;
 	QFutureWatcher<bool> m_copyFutureWatcher;
 	std::unique_ptr<IPathMatcher> m_matcher;
+	std::unique_ptr<IPathMatcher> m_hardlinkMatcher;
+	QAtomicInt m_aborted;
 };
 
 
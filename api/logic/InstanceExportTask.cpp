@@ -0,0 +1,390 @@
+#include "InstanceExportTask.h"
+#include "FileSystem.h"
+
+#include <quazip.h>
+#include <quazipfile.h>
+#include <quazipnewinfo.h>
+#include <zlib.h>
+
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <QDir>
+#include <QSet>
+#include <QDebug>
+#include <functional>
+
+namespace
+{
+// files this big are streamed into the zip by the writer instead of being read into memory
+const qint64 streamThreshold = 16 * 1024 * 1024;
+
+// how much file data, and how many files, one batch packed in parallel may hold
+const qint64 batchBytes = 32 * 1024 * 1024;
+const int batchFiles = 256;
+
+struct Entry
+{
+	// path inside the zip, directories end with a '/'
+	QString name;
+	// path on disk
+	QString path;
+	qint64 size = 0;
+	bool dir = false;
+};
+
+struct PackedEntry
+{
+	Entry entry;
+	QByteArray data;
+	quint32 crc = 0;
+	int method = 0;
+	bool ok = false;
+};
+
+// deflating these again takes time and gains nothing
+bool isCompressed(const QString &path)
+{
+	static const QSet<QString> suffixes = {
+		"jar", "zip", "litemod", "png", "jpg", "jpeg", "ogg", "mp3", "gz", "xz", "lzma", "7z", "mca", "mcr"
+	};
+	return suffixes.contains(QFileInfo(path).suffix().toLower());
+}
+
+bool isSmall(const Entry &entry)
+{
+	return !entry.dir && entry.size < streamThreshold;
+}
+
+bool deflateRaw(const QByteArray &in, QByteArray &out)
+{
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	// negative window bits - no zlib header, zip entries are raw deflate streams
+	if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		return false;
+	}
+	out.resize(deflateBound(&zs, in.size()));
+	zs.next_in = (Bytef *)in.constData();
+	zs.avail_in = in.size();
+	zs.next_out = (Bytef *)out.data();
+	zs.avail_out = out.size();
+	// the output buffer is big enough for everything, one call is all it takes
+	int ret = deflate(&zs, Z_FINISH);
+	out.resize(zs.total_out);
+	deflateEnd(&zs);
+	return ret == Z_STREAM_END;
+}
+
+// runs on worker threads
+PackedEntry pack(const Entry &entry)
+{
+	PackedEntry packed;
+	packed.entry = entry;
+	QFile file(entry.path);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		qWarning() << "Failed to open" << entry.path << "for export:" << file.errorString();
+		return packed;
+	}
+	auto data = file.readAll();
+	if (file.error() != QFile::NoError)
+	{
+		qWarning() << "Failed to read" << entry.path << "for export:" << file.errorString();
+		return packed;
+	}
+	packed.entry.size = data.size();
+	packed.crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef *)data.constData(), data.size());
+	if (!isCompressed(entry.path) && deflateRaw(data, packed.data) && packed.data.size() < data.size())
+	{
+		packed.method = Z_DEFLATED;
+	}
+	else
+	{
+		packed.data = data;
+		packed.method = 0;
+	}
+	packed.ok = true;
+	return packed;
+}
+
+bool writeDirectory(QuaZip *zip, const Entry &entry)
+{
+	QuaZipFile file(zip);
+	if (!file.open(QIODevice::WriteOnly, QuaZipNewInfo(entry.name, entry.path)))
+	{
+		return false;
+	}
+	file.close();
+	return file.getZipError() == 0;
+}
+
+bool writePacked(QuaZip *zip, const PackedEntry &packed)
+{
+	QuaZipNewInfo info(packed.entry.name, packed.entry.path);
+	info.uncompressedSize = packed.entry.size;
+	// the data is already compressed and the CRC is known, write it raw
+	QuaZipFile file(zip);
+	if (!file.open(QIODevice::WriteOnly, info, nullptr, packed.crc, packed.method, Z_DEFAULT_COMPRESSION, true))
+	{
+		return false;
+	}
+	if (file.write(packed.data) != packed.data.size())
+	{
+		file.close();
+		return false;
+	}
+	file.close();
+	return file.getZipError() == 0;
+}
+}
+
+InstanceExportTask::InstanceExportTask(InstancePtr instance, const QString &output, const QString &prefix,
+	const SeparatorPrefixTree<'/'> &blocked)
+	: m_instance(instance), m_output(output), m_prefix(prefix), m_blocked(blocked)
+{
+	m_writerPool.setMaxThreadCount(1);
+}
+
+InstanceExportTask::~InstanceExportTask()
+{
+	// the writer uses this object, do not let it outlive it
+	m_aborted.storeRelease(1);
+	m_exportFuture.waitForFinished();
+}
+
+void InstanceExportTask::executeTask()
+{
+	setStatus(tr("Exporting instance %1").arg(m_instance->name()));
+
+	m_exportFuture = QtConcurrent::run(&m_writerPool, this, &InstanceExportTask::exportInstance);
+	connect(&m_exportFutureWatcher, &QFutureWatcher<bool>::finished, this, &InstanceExportTask::exportFinished);
+	m_exportFutureWatcher.setFuture(m_exportFuture);
+}
+
+bool InstanceExportTask::abort()
+{
+	m_aborted.storeRelease(1);
+	return true;
+}
+
+void InstanceExportTask::exportFinished()
+{
+	if (m_exportFuture.result())
+	{
+		emitSucceeded();
+	}
+	else if (m_aborted.loadAcquire())
+	{
+		emitAborted();
+	}
+	else
+	{
+		emitFailed(m_error);
+	}
+}
+
+// runs on the writer thread
+bool InstanceExportTask::exportInstance()
+{
+	auto root = m_instance->instanceRoot();
+	QDir rootDir(root);
+
+	QList<Entry> entries;
+	qint64 total = 0;
+	{
+		Entry top;
+		top.name = m_prefix + '/';
+		top.path = root;
+		top.dir = true;
+		entries.append(top);
+	}
+	std::function<void(const QString &)> walk = [&](const QString &path)
+	{
+		auto list = QDir(path).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+			QDir::Name | QDir::DirsFirst);
+		for (auto &info : list)
+		{
+			auto relative = rootDir.relativeFilePath(info.absoluteFilePath());
+			if (m_blocked.covers(relative))
+			{
+				continue;
+			}
+			Entry entry;
+			entry.path = info.absoluteFilePath();
+			entry.name = m_prefix + '/' + relative;
+			if (info.isDir())
+			{
+				entry.name += '/';
+				entry.dir = true;
+				entries.append(entry);
+				// do not follow linked folders, they can lead anywhere (including back here)
+				if (!info.isSymLink())
+				{
+					walk(entry.path);
+				}
+			}
+			else
+			{
+				entry.size = info.size();
+				total += entry.size;
+				entries.append(entry);
+			}
+		}
+	};
+	walk(root);
+
+	qint64 done = 0;
+	auto addProgress = [&](qint64 bytes)
+	{
+		done += bytes;
+		reportProgress(done, total);
+	};
+	addProgress(0);
+
+	// write next to the target and only replace it when everything is in
+	auto partPath = m_output + ".part";
+	QuaZip zip(partPath);
+	if (!zip.open(QuaZip::mdCreate))
+	{
+		m_error = tr("Could not create %1").arg(partPath);
+		return false;
+	}
+
+	// splits the entries into ranges with a bounded amount of small files to pack in parallel
+	auto rangeEnd = [&](int begin)
+	{
+		qint64 bytes = 0;
+		int files = 0;
+		int end = begin;
+		while (end < entries.size() && bytes < batchBytes && files < batchFiles)
+		{
+			if (isSmall(entries[end]))
+			{
+				bytes += entries[end].size;
+				files++;
+			}
+			end++;
+		}
+		return end;
+	};
+	auto packRange = [&](int begin, int end)
+	{
+		QList<Entry> small;
+		for (int i = begin; i < end; i++)
+		{
+			if (isSmall(entries[i]))
+			{
+				small.append(entries[i]);
+			}
+		}
+		return QtConcurrent::mapped(small, pack);
+	};
+
+	QFuture<PackedEntry> current;
+	QFuture<PackedEntry> next;
+	auto fail = [&](const QString &error)
+	{
+		current.cancel();
+		next.cancel();
+		current.waitForFinished();
+		next.waitForFinished();
+		zip.close();
+		QFile::remove(partPath);
+		m_error = error;
+		return false;
+	};
+
+	auto streamFile = [&](const Entry &entry)
+	{
+		QFile in(entry.path);
+		if (!in.open(QIODevice::ReadOnly))
+		{
+			return false;
+		}
+		QuaZipFile out(&zip);
+		int method = isCompressed(entry.path) ? 0 : Z_DEFLATED;
+		if (!out.open(QIODevice::WriteOnly, QuaZipNewInfo(entry.name, entry.path), nullptr, 0, method))
+		{
+			return false;
+		}
+		while (!in.atEnd())
+		{
+			auto chunk = in.read(1024 * 1024);
+			if (m_aborted.loadAcquire() || in.error() != QFile::NoError || out.write(chunk) != chunk.size())
+			{
+				out.close();
+				return false;
+			}
+			addProgress(chunk.size());
+		}
+		out.close();
+		return out.getZipError() == 0;
+	};
+
+	int begin = 0;
+	int end = rangeEnd(begin);
+	current = packRange(begin, end);
+	while (begin < entries.size())
+	{
+		// pack the next range while this one is being written
+		int nextEnd = rangeEnd(end);
+		next = packRange(end, nextEnd);
+
+		int packedIndex = 0;
+		for (int i = begin; i < end; i++)
+		{
+			if (m_aborted.loadAcquire())
+			{
+				return fail(tr("Export aborted."));
+			}
+			const auto &entry = entries[i];
+			bool ok = false;
+			if (entry.dir)
+			{
+				ok = writeDirectory(&zip, entry);
+			}
+			else if (isSmall(entry))
+			{
+				auto packed = current.resultAt(packedIndex++);
+				ok = packed.ok && writePacked(&zip, packed);
+				if (ok)
+				{
+					addProgress(packed.entry.size);
+				}
+			}
+			else
+			{
+				ok = streamFile(entry);
+			}
+			if (!ok)
+			{
+				return fail(tr("Could not add %1 to the zip file.").arg(entry.path));
+			}
+		}
+		current = next;
+		begin = end;
+		end = nextEnd;
+	}
+
+	zip.close();
+	if (zip.getZipError() != 0)
+	{
+		QFile::remove(partPath);
+		m_error = tr("Could not finish writing %1").arg(partPath);
+		return false;
+	}
+	if (QFile::exists(m_output) && !QFile::remove(m_output))
+	{
+		QFile::remove(partPath);
+		m_error = tr("Could not replace %1").arg(m_output);
+		return false;
+	}
+	if (!QFile::rename(partPath, m_output))
+	{
+		QFile::remove(partPath);
+		m_error = tr("Could not move the export to %1").arg(m_output);
+		return false;
+	}
+	return true;
+}
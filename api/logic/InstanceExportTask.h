@@ -0,0 +1,58 @@
+#pragma once
+
+#include "tasks/Task.h"
+#include "multimc_logic_export.h"
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include "BaseInstance.h"
+#include "SeparatorPrefixTree.h"
+
+/**
+ * Packs an instance folder into a zip file in the background.
+ *
+ * Files are deflated in parallel and written to the zip in order by a single writer.
+ * Formats that are already compressed (jars, images, sounds...) are stored as they are.
+ */
+class MULTIMC_LOGIC_EXPORT InstanceExportTask : public Task
+{
+	Q_OBJECT
+public:
+	/**
+	 * \param output the zip file to create, it is only replaced once the export succeeds
+	 * \param prefix folder inside the zip that holds the instance files
+	 * \param blocked paths relative to the instance folder that are left out
+	 */
+	explicit InstanceExportTask(InstancePtr instance, const QString &output, const QString &prefix,
+		const SeparatorPrefixTree<'/'> &blocked);
+	virtual ~InstanceExportTask();
+
+	bool canAbort() const override
+	{
+		return true;
+	}
+
+public slots:
+	bool abort() override;
+
+protected:
+	//! Entry point for tasks.
+	virtual void executeTask() override;
+	void exportFinished();
+
+private:
+	bool exportInstance();
+
+private: /* data */
+	InstancePtr m_instance;
+	QString m_output;
+	QString m_prefix;
+	SeparatorPrefixTree<'/'> m_blocked;
+	QString m_error;
+	QAtomicInt m_aborted;
+	// the writer gets its own thread so it never waits on workers it is occupying itself
+	QThreadPool m_writerPool;
+	QFuture<bool> m_exportFuture;
+	QFutureWatcher<bool> m_exportFutureWatcher;
+};
@@ -79,29 +79,29 @@ void InstanceImportTask::processZipPack()
 	qDebug() << "Attempting to create instance from" << m_archivePath;
 
 	// open the zip and find relevant files in it
-	m_packZip.reset(new QuaZip(m_archivePath));
-	if (!m_packZip->open(QuaZip::mdUnzip))
+	QMap<QString, QString> found;
 	{
-		emitFailed(tr("Unable to open supplied modpack zip file."));
-		return;
+		QuaZip packZip(m_archivePath);
+		if (!packZip.open(QuaZip::mdUnzip))
+		{
+			emitFailed(tr("Unable to open supplied modpack zip file."));
+			return;
+		}
+		found = MMCZip::findFoldersOfFilesInZip(&packZip, {"instance.cfg", "manifest.json"});
 	}
-
-	QStringList blacklist = {"instance.cfg", "manifest.json"};
-	QString mmcFound = MMCZip::findFolderOfFileInZip(m_packZip.get(), "instance.cfg");
-	QString flameFound = MMCZip::findFolderOfFileInZip(m_packZip.get(), "manifest.json");
 	QString root;
-	if(!mmcFound.isNull())
+	if(found.contains("instance.cfg"))
 	{
 		// process as MultiMC instance/pack
-		qDebug() << "MultiMC:" << mmcFound;
-		root = mmcFound;
+		root = found["instance.cfg"];
+		qDebug() << "MultiMC:" << root;
 		m_modpackType = ModpackType::MultiMC;
 	}
-	else if(!flameFound.isNull())
+	else if(found.contains("manifest.json"))
 	{
 		// process as Flame pack
-		qDebug() << "Flame:" << flameFound;
-		root = flameFound;
+		root = found["manifest.json"];
+		qDebug() << "Flame:" << root;
 		m_modpackType = ModpackType::Flame;
 	}
 
@@ -112,7 +112,18 @@ void InstanceImportTask::processZipPack()
 	}
 
 	// make sure we extract just the pack
-	m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), root, extractDir.absolutePath());
+	auto progress = [this](qint64 current, qint64 total)
+	{
+		// the download, if there was one, was the first half
+		if(m_downloadRequired)
+		{
+			current += total;
+			total *= 2;
+		}
+		reportProgress(current, total);
+	};
+	std::function<void(qint64, qint64)> progressFunction = progress;
+	m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDirParallel, m_archivePath, root, extractDir.absolutePath(), progressFunction);
 	connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
 	connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &InstanceImportTask::extractAborted);
 	m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -120,44 +131,12 @@ void InstanceImportTask::processZipPack()
 
 void InstanceImportTask::extractFinished()
 {
-	m_packZip.reset();
+	// permissions were fixed up as the files were extracted
 	if (m_extractFuture.result().isEmpty())
 	{
 		emitFailed(tr("Failed to extract modpack"));
 		return;
 	}
-	QDir extractDir(m_stagingPath);
-
-	qDebug() << "Fixing permissions for extracted pack files...";
-	QDirIterator it(extractDir, QDirIterator::Subdirectories);
-	while (it.hasNext())
-	{
-		auto filepath = it.next();
-		QFileInfo file(filepath);
-		auto permissions = QFile::permissions(filepath);
-		auto origPermissions = permissions;
-		if(file.isDir())
-		{
-			// Folder +rwx for current user
-			permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser;
-		}
-		else
-		{
-			// File +rw for current user
-			permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser;
-		}
-		if(origPermissions != permissions)
-		{
-			if(!QFile::setPermissions(filepath, permissions))
-			{
-				qWarning() << "Could not fix" << filepath;
-			}
-			else
-			{
-				qDebug() << "Fixed" << filepath;
-			}
-		}
-	}
 
 	switch(m_modpackType)
 	{
@@ -300,57 +279,78 @@ void InstanceImportTask::processFlame()
 	}
 	instance.setName(m_instName);
 	m_modIdResolver.reset(new Flame::FileResolvingTask(pack));
-	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::succeeded, [&]()
+	// mods are downloaded as soon as they are resolved, the download job stays open until resolving is done
+	m_filesNetJob.reset(new NetJob(tr("Mod download")));
+	m_filesNetJob->holdOpen(true);
+	m_resolveProgress = 0;
+	m_downloadProgress = 0;
+	m_modCount = pack.files.size();
+	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::fileResolved, this, [this](int index)
 	{
-		auto results = m_modIdResolver->getResults();
-		m_filesNetJob.reset(new NetJob(tr("Mod download")));
-		for(auto result: results.files)
+		auto result = m_modIdResolver->getResults().files[index];
+		QString filename = result.fileName;
+		if(!result.required)
 		{
-			QString filename = result.fileName;
-			if(!result.required)
-			{
-				filename += ".disabled";
-			}
-			auto path = FS::PathCombine(m_stagingPath ,"minecraft", result.targetFolder, filename);
-			auto dl = Net::Download::makeFile(result.url, path);
-			m_filesNetJob->addNetAction(dl);
+			filename += ".disabled";
 		}
+		auto path = FS::PathCombine(m_stagingPath ,"minecraft", result.targetFolder, filename);
+		auto dl = Net::Download::makeFile(result.url, path);
+		m_filesNetJob->addNetAction(dl);
+	});
+	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::succeeded, this, [this]()
+	{
 		m_modIdResolver.reset();
-		connect(m_filesNetJob.get(), &NetJob::succeeded, this, [&]()
-		{
-			m_filesNetJob.reset();
-			emitSucceeded();
-		}
-		);
-		connect(m_filesNetJob.get(), &NetJob::failed, [&](QString reason)
-		{
-			m_filesNetJob.reset();
-			emitFailed(reason);
-		});
-		connect(m_filesNetJob.get(), &NetJob::progress, [&](qint64 current, qint64 total)
-		{
-			setProgress(current, total);
-		});
 		setStatus(tr("Downloading mods..."));
-		m_filesNetJob->start();
-	}
-	);
-	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::failed, [&](QString reason)
+		m_filesNetJob->holdOpen(false);
+	});
+	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::failed, this, [this](QString reason)
 	{
 		m_modIdResolver.reset();
+		m_filesNetJob->disconnect(this);
+		m_filesNetJob->abort();
+		m_filesNetJob.reset();
 		emitFailed(tr("Unable to resolve mod IDs:\n") + reason);
 	});
-	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::progress, [&](qint64 current, qint64 total)
+	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::progress, this, [this](qint64 current, qint64)
 	{
-		setProgress(current, total);
+		m_resolveProgress = current;
+		flameProgress();
 	});
-	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::status, [&](QString status)
+	connect(m_modIdResolver.get(), &Flame::FileResolvingTask::status, this, [this](QString status)
 	{
 		setStatus(status);
 	});
+	connect(m_filesNetJob.get(), &NetJob::succeeded, this, [this]()
+	{
+		m_filesNetJob.reset();
+		emitSucceeded();
+	});
+	connect(m_filesNetJob.get(), &NetJob::failed, this, [this](QString reason)
+	{
+		if(m_modIdResolver)
+		{
+			m_modIdResolver->disconnect(this);
+			m_modIdResolver->abort();
+			m_modIdResolver.reset();
+		}
+		m_filesNetJob.reset();
+		emitFailed(reason);
+	});
+	connect(m_filesNetJob.get(), &NetJob::progress, this, [this](qint64 current, qint64)
+	{
+		m_downloadProgress = current;
+		flameProgress();
+	});
+	m_filesNetJob->start();
 	m_modIdResolver->start();
 }
 
+void InstanceImportTask::flameProgress()
+{
+	// every mod counts once for resolving it and once for downloading it, downloads report 1000 per part
+	setProgress(m_resolveProgress * 1000 + m_downloadProgress, qMax<qint64>(m_modCount, 1) * 2000);
+}
+
 void InstanceImportTask::processMultiMC()
 {
 	// FIXME: copy from FolderInstanceProvider!!! FIX IT!!!
@@ -9,7 +9,6 @@
 #include "settings/SettingsObject.h"
 #include "QObjectPtr.h"
 
-class QuaZip;
 class BaseInstanceProvider;
 namespace Flame
 {
@@ -31,6 +30,7 @@ private:
 	void processZipPack();
 	void processMultiMC();
 	void processFlame();
+	void flameProgress();
 
 private slots:
 	void downloadSucceeded();
@@ -43,6 +43,9 @@ private: /* data */
 	SettingsObjectPtr m_globalSettings;
 	NetJobPtr m_filesNetJob;
 	shared_qobject_ptr<Flame::FileResolvingTask> m_modIdResolver;
+	qint64 m_modCount = 0;
+	qint64 m_resolveProgress = 0;
+	qint64 m_downloadProgress = 0;
 	QUrl m_sourceUrl;
 	QString m_archivePath;
 	bool m_downloadRequired = false;
@@ -50,7 +53,6 @@ private: /* data */
 	QString m_instIcon;
 	QString m_instGroup;
 	QString m_stagingPath;
-	std::unique_ptr<QuaZip> m_packZip;
 	QFuture<QStringList> m_extractFuture;
 	QFutureWatcher<QStringList> m_extractFutureWatcher;
 	enum class ModpackType{
@@ -20,6 +20,7 @@
 #include <QTextStream>
 #include <QXmlStreamReader>
 #include <QDebug>
+#include <QtConcurrentMap>
 
 #include "InstanceList.h"
 #include "BaseInstance.h"
@@ -30,11 +31,19 @@ InstanceList::InstanceList(SettingsObjectPtr globalSettings, const QString &inst
 	: QAbstractListModel(parent), m_instDir(instDir)
 {
 	m_globalSettings = globalSettings;
+	connect(&m_loadWatcher, &QFutureWatcher<InstancePrefetchPtr>::resultReadyAt, this, &InstanceList::instancePrefetched);
+	connect(&m_loadWatcher, &QFutureWatcher<InstancePrefetchPtr>::finished, this, &InstanceList::loadFinished);
+	// new instances are added at most this often, so the view isn't updated for every single one
+	m_publishTimer.setSingleShot(true);
+	m_publishTimer.setInterval(50);
+	connect(&m_publishTimer, &QTimer::timeout, this, &InstanceList::publishLoaded);
 	resumeWatch();
 }
 
 InstanceList::~InstanceList()
 {
+	m_loadWatcher.cancel();
+	m_loadWatcher.waitForFinished();
 }
 
 int InstanceList::rowCount(const QModelIndex &parent) const
@@ -138,31 +147,31 @@ static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr> &
 
 InstanceList::InstListError InstanceList::loadList(bool complete)
 {
+	if(m_loading)
+	{
+		// what is loading now isn't in the list yet, so go again once it is
+		m_reloadRequested = true;
+		m_reloadComplete |= complete;
+		return NoError;
+	}
+
 	auto existingIds = getIdMapping(m_instances);
 
-	QList<InstancePtr> newList;
+	QList<PendingInstance> pending;
 
 	auto processIds = [&](BaseInstanceProvider * provider, QList<InstanceId> ids)
 	{
+		auto prefetcher = provider->prefetcher();
 		for(auto & id: ids)
 		{
-			if(existingIds.contains(id))
+			// unchanged instances are kept as they are, instances from the snapshot that changed since are replaced
+			if(existingIds.contains(id) && !provider->isStale(id))
 			{
-				auto instPair = existingIds[id];
-				/*
-				auto & instPtr = instPair.first;
-				auto & instIdx = instPair.second;
-				*/
 				existingIds.remove(id);
-				qDebug() << "Should keep and soft-reload" << id;
 			}
 			else
 			{
-				InstancePtr instPtr = provider->loadInstance(id);
-				if(instPtr)
-				{
-					newList.append(instPtr);
-				}
+				pending.append({provider, id, prefetcher});
 			}
 		}
 	};
@@ -233,12 +242,107 @@ InstanceList::InstListError InstanceList::loadList(bool complete)
 			removeNow();
 		}
 	}
+	m_updatedProviders.clear();
+
+	if(pending.isEmpty())
+	{
+		saveSnapshots();
+		emit listLoaded();
+		return NoError;
+	}
+	// read the new instances on worker threads, they get added as they come in
+	m_loading = true;
+	m_pending = pending;
+	std::function<InstancePrefetchPtr(const PendingInstance &)> prefetch = [](const PendingInstance & instance) -> InstancePrefetchPtr
+	{
+		if(!instance.prefetcher)
+		{
+			return nullptr;
+		}
+		return instance.prefetcher(instance.id);
+	};
+	m_loadWatcher.setFuture(QtConcurrent::mapped(m_pending, prefetch));
+	return NoError;
+}
+
+void InstanceList::loadSnapshot()
+{
+	auto existingIds = getIdMapping(m_instances);
+	QList<InstancePtr> newList;
+	for(auto & provider: m_providers)
+	{
+		auto snapshot = provider->snapshot();
+		for(auto iter = snapshot.begin(); iter != snapshot.end(); iter++)
+		{
+			if(existingIds.contains(iter.key()))
+			{
+				continue;
+			}
+			InstancePtr instPtr = provider->loadInstance(iter.key(), iter.value());
+			if(instPtr)
+			{
+				newList.append(instPtr);
+			}
+		}
+	}
 	if(newList.size())
 	{
 		add(newList);
 	}
-	m_updatedProviders.clear();
-	return NoError;
+}
+
+void InstanceList::saveSnapshots()
+{
+	for(auto & provider: m_providers)
+	{
+		provider->saveSnapshot();
+	}
+}
+
+void InstanceList::instancePrefetched(int index)
+{
+	m_prefetched.append(index);
+	if(!m_publishTimer.isActive())
+	{
+		m_publishTimer.start();
+	}
+}
+
+void InstanceList::publishLoaded()
+{
+	QList<InstancePtr> newList;
+	for(auto index: m_prefetched)
+	{
+		auto & instance = m_pending[index];
+		InstancePtr instPtr = instance.provider->loadInstance(instance.id, m_loadWatcher.resultAt(index));
+		if(instPtr)
+		{
+			newList.append(instPtr);
+		}
+	}
+	m_prefetched.clear();
+	if(newList.size())
+	{
+		add(newList);
+	}
+}
+
+void InstanceList::loadFinished()
+{
+	m_publishTimer.stop();
+	publishLoaded();
+	qDebug() << "Loaded" << m_pending.size() << "instances";
+	m_pending.clear();
+	m_loading = false;
+	saveSnapshots();
+	emit listLoaded();
+	if(m_reloadRequested)
+	{
+		bool complete = m_reloadComplete;
+		m_reloadRequested = false;
+		m_reloadComplete = false;
+		loadList(complete);
+	}
 }
 
 void InstanceList::add(const QList<InstancePtr> &t)
@@ -19,6 +19,8 @@
 #include <QAbstractListModel>
 #include <QSet>
 #include <QList>
+#include <QFutureWatcher>
+#include <QTimer>
 
 #include "BaseInstance.h"
 #include "BaseInstanceProvider.h"
@@ -72,8 +74,24 @@ public:
 		return m_instances.count();
 	}
 
+	/**
+	 * Find new and removed instances. Removed instances go away right away, new ones are read
+	 * in the background and added in batches as they come in. listLoaded is emitted when done.
+	 */
 	InstListError loadList(bool complete = false);
 
+	/**
+	 * Fill the list with the instances the providers remembered from last time, without
+	 * touching the instance folders. The next loadList checks them and reloads what changed.
+	 */
+	void loadSnapshot();
+
+	/// @return true if instances are still being loaded
+	bool isLoading() const
+	{
+		return m_loading;
+	}
+
 	/// Add an instance provider. Takes ownership of it. Should only be done before the first load.
 	void addInstanceProvider(BaseInstanceProvider * provider);
 
@@ -85,17 +103,30 @@ public:
 
 signals:
 	void dataIsInvalid();
+	void listLoaded();
 
 private slots:
 	void propertiesChanged(BaseInstance *inst);
 	void groupsPublished(QSet<QString>);
 	void providerUpdated();
+	void instancePrefetched(int index);
+	void publishLoaded();
+	void loadFinished();
 
 private:
 	int getInstIndex(BaseInstance *inst) const;
 	void suspendWatch();
 	void resumeWatch();
 	void add(const QList<InstancePtr> &list);
+	void saveSnapshots();
+
+private: /* types */
+	struct PendingInstance
+	{
+		BaseInstanceProvider * provider;
+		InstanceId id;
+		InstancePrefetcher prefetcher;
+	};
 
 protected:
 	int m_watchLevel = 0;
@@ -105,4 +136,16 @@ protected:
 	QSet<QString> m_groups;
 	SettingsObjectPtr m_globalSettings;
 	QVector<shared_qobject_ptr<BaseInstanceProvider>> m_providers;
+
+private:
+	// instances being loaded in the background
+	QList<PendingInstance> m_pending;
+	QFutureWatcher<InstancePrefetchPtr> m_loadWatcher;
+	// indexes of prefetched instances waiting to be added
+	QList<int> m_prefetched;
+	QTimer m_publishTimer;
+	bool m_loading = false;
+	// loadList was called again while loading
+	bool m_reloadRequested = false;
+	bool m_reloadComplete = false;
 };
@@ -0,0 +1,148 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QDir>
+#include "TestUtil.h"
+
+#include "InstanceList.h"
+#include "FolderInstanceProvider.h"
+#include "settings/INISettingsObject.h"
+#include "FileSystem.h"
+
+class InstanceListTest : public QObject
+{
+	Q_OBJECT
+private:
+	QTemporaryDir m_dir;
+	SettingsObjectPtr m_globalSettings;
+	const int m_count = 400;
+
+	QString instDir()
+	{
+		return FS::PathCombine(m_dir.path(), "instances");
+	}
+
+	std::unique_ptr<InstanceList> createList()
+	{
+		std::unique_ptr<InstanceList> list(new InstanceList(m_globalSettings, instDir()));
+		list->addInstanceProvider(new FolderInstanceProvider(m_globalSettings, instDir()));
+		return list;
+	}
+
+	void loadFromDisk(InstanceList &list)
+	{
+		QSignalSpy loaded(&list, SIGNAL(listLoaded()));
+		list.loadList(true);
+		QVERIFY(loaded.size() == 1 || loaded.wait(10000));
+	}
+
+	QSet<QString> names(InstanceList &list)
+	{
+		QSet<QString> out;
+		for(int i = 0; i < list.count(); i++)
+		{
+			out.insert(list.at(i)->name());
+		}
+		return out;
+	}
+
+	void writeInstance(int i, const QString &name)
+	{
+		auto path = FS::PathCombine(instDir(), QString("instance-%1").arg(i));
+		QDir().mkpath(path);
+		FS::write(FS::PathCombine(path, "instance.cfg"),
+			QString("InstanceType=Test\nname=%1\niconKey=default\ntotalTimePlayed=%2\n").arg(name).arg(i).toUtf8());
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+		m_globalSettings = std::make_shared<INISettingsObject>(FS::PathCombine(m_dir.path(), "multimc.cfg"));
+		for(auto id: {"PreLaunchCommand", "WrapperCommand", "PostExitCommand"})
+		{
+			m_globalSettings->registerSetting(id, "");
+		}
+		for(auto id: {"ShowConsole", "AutoCloseConsole", "ShowConsoleOnError", "LogPrePostOutput", "ConsoleOverflowStop"})
+		{
+			m_globalSettings->registerSetting(id, false);
+		}
+		m_globalSettings->registerSetting("ConsoleMaxLines", 100000);
+		for(int i = 0; i < m_count; i++)
+		{
+			writeInstance(i, QString("Instance %1").arg(i));
+		}
+	}
+
+	void test_snapshot()
+	{
+		auto fromDisk = createList();
+		QCOMPARE(fromDisk->count(), 0);
+		loadFromDisk(*fromDisk);
+		QCOMPARE(fromDisk->count(), m_count);
+		auto expected = names(*fromDisk);
+		fromDisk.reset();
+
+		// the next start gets the same instances without reading them
+		auto fromSnapshot = createList();
+		fromSnapshot->loadSnapshot();
+		QCOMPARE(fromSnapshot->count(), m_count);
+		QCOMPARE(names(*fromSnapshot), expected);
+		QCOMPARE(fromSnapshot->getInstanceById("instance-7")->name(), QString("Instance 7"));
+	}
+
+	void test_staleSnapshot()
+	{
+		{
+			auto list = createList();
+			loadFromDisk(*list);
+		}
+		writeInstance(3, "Renamed instance");
+		FS::deletePath(FS::PathCombine(instDir(), "instance-5"));
+
+		auto list = createList();
+		list->loadSnapshot();
+		QCOMPARE(list->getInstanceById("instance-3")->name(), QString("Instance 3"));
+		QCOMPARE(list->count(), m_count);
+		loadFromDisk(*list);
+		QCOMPARE(list->getInstanceById("instance-3")->name(), QString("Renamed instance"));
+		QVERIFY(!list->getInstanceById("instance-5"));
+		QCOMPARE(list->count(), m_count - 1);
+		writeInstance(5, "Instance 5");
+	}
+
+	// how long until the instance list is filled, which is what the main window waits for to show something
+	void test_startup_data()
+	{
+		QTest::addColumn<bool>("snapshot");
+		QTest::newRow("instance folders") << false;
+		QTest::newRow("snapshot") << true;
+	}
+	void test_startup()
+	{
+		QFETCH(bool, snapshot);
+		{
+			// make sure there is an up to date snapshot
+			auto list = createList();
+			loadFromDisk(*list);
+		}
+		QBENCHMARK
+		{
+			auto list = createList();
+			if(snapshot)
+			{
+				list->loadSnapshot();
+			}
+			else
+			{
+				loadFromDisk(*list);
+			}
+			QCOMPARE(list->count(), m_count);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(InstanceListTest)
+
+#include "InstanceList_test.moc"
@@ -20,26 +20,51 @@ LoggedProcess::~LoggedProcess()
 	}
 }
 
-QStringList reprocess(const QByteArray & data, QString & leftover)
+namespace {
+/*
+ * Split the complete lines off the data read so far. Only whole lines are decoded, the
+ * incomplete tail stays as bytes so a multi-byte character split between reads survives.
+ */
+QStringList reprocess(const QByteArray & data, QByteArray & leftover)
 {
-	QString str = leftover + QString::fromLocal8Bit(data);
+	leftover.append(data);
+	int end = leftover.lastIndexOf('\n');
+	if(end < 0)
+	{
+		return {};
+	}
+	QString str = QString::fromLocal8Bit(leftover.constData(), end);
+	leftover.remove(0, end + 1);
 
 	str.remove('\r');
-	QStringList lines = str.split("\n");
-	leftover = lines.takeLast();
-	return lines;
+	return str.split('\n');
+}
+
+QString flush(QByteArray & leftover)
+{
+	QString str = QString::fromLocal8Bit(leftover);
+	leftover.clear();
+	str.remove('\r');
+	return str;
+}
 }
 
 void LoggedProcess::on_stdErr()
 {
 	auto lines = reprocess(readAllStandardError(), m_err_leftover);
-	emit log(lines, MessageLevel::StdErr);
+	if(!lines.isEmpty())
+	{
+		emit log(lines, MessageLevel::StdErr);
+	}
 }
 
 void LoggedProcess::on_stdOut()
 {
 	auto lines = reprocess(readAllStandardOutput(), m_out_leftover);
-	emit log(lines, MessageLevel::StdOut);
+	if(!lines.isEmpty())
+	{
+		emit log(lines, MessageLevel::StdOut);
+	}
 }
 
 void LoggedProcess::on_exit(int exit_code, QProcess::ExitStatus status)
@@ -50,13 +75,11 @@ void LoggedProcess::on_exit(int exit_code, QProcess::ExitStatus status)
 	// Flush console window
 	if (!m_err_leftover.isEmpty())
 	{
-		emit log({m_err_leftover}, MessageLevel::StdErr);
-		m_err_leftover.clear();
+		emit log({flush(m_err_leftover)}, MessageLevel::StdErr);
 	}
 	if (!m_out_leftover.isEmpty())
 	{
-		emit log({m_err_leftover}, MessageLevel::StdOut);
-		m_out_leftover.clear();
+		emit log({flush(m_out_leftover)}, MessageLevel::StdOut);
 	}
 
 	// based on state, send signals
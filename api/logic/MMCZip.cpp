@@ -21,6 +21,11 @@
 #include "FileSystem.h"
 
 #include <QDebug>
+#include <QVector>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <atomic>
 
 // ours
 bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained, const JlCompress::FilterFunction filter)
@@ -47,15 +52,25 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
 		}
 		contained.insert(filename);
 
-		if (!fileInsideMod.open(QIODevice::ReadOnly))
+		QuaZipFileInfo64 info_in;
+		if (!modZip.getCurrentFileInfo(&info_in))
+		{
+			qCritical() << "Failed to read the header of " << filename << " from " << from.fileName();
+			return false;
+		}
+
+		// copy the entry as it is stored - no need to inflate and deflate it again
+		int method = 0;
+		int level = 0;
+		if (!fileInsideMod.open(QIODevice::ReadOnly, &method, &level, true))
 		{
 			qCritical() << "Failed to open " << filename << " from " << from.fileName();
 			return false;
 		}
 
-		QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+		QuaZipNewInfo info_out(info_in);
 
-		if (!zipOutFile.open(QIODevice::WriteOnly, info_out))
+		if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, info_in.crc, method, level, true))
 		{
 			qCritical() << "Failed to open " << filename << " in the jar";
 			fileInsideMod.close();
@@ -187,6 +202,31 @@ QString MMCZip::findFolderOfFileInZip(QuaZip * zip, const QString & what, const
 	return QString();
 }
 
+// ours
+QMap<QString, QString> MMCZip::findFoldersOfFilesInZip(QuaZip * zip, const QStringList & what)
+{
+	QMap<QString, QString> found;
+	QMap<QString, int> depths;
+	for(auto &path: zip->getFileNameList())
+	{
+		auto slash = path.lastIndexOf('/');
+		auto fileName = path.mid(slash + 1);
+		if(fileName.isEmpty() || !what.contains(fileName))
+		{
+			continue;
+		}
+		auto folder = path.left(slash + 1);
+		int depth = folder.count('/');
+		auto iter = depths.find(fileName);
+		if(iter == depths.end() || depth < *iter)
+		{
+			depths[fileName] = depth;
+			found[fileName] = folder;
+		}
+	}
+	return found;
+}
+
 // ours
 bool MMCZip::findFilesInZip(QuaZip * zip, const QString & what, QStringList & result, const QString &root)
 {
@@ -239,6 +279,183 @@ QStringList MMCZip::extractSubDir(QuaZip *zip, const QString & subdir, const QSt
 	return extracted;
 }
 
+// ours
+QStringList MMCZip::extractSubDirParallel(const QString & archivePath, const QString & subdir, const QString &target,
+										  const std::function<void(qint64, qint64)> & progress)
+{
+	QList<QuaZipFileInfo64> infos;
+	{
+		QuaZip zip(archivePath);
+		if (!zip.open(QuaZip::mdUnzip))
+		{
+			return QStringList();
+		}
+		infos = zip.getFileInfoList64();
+	}
+
+	// contiguous runs of entries holding about the same amount of data, a few per thread to even out the load
+	struct Chunk
+	{
+		int first = 0;
+		int count = 0;
+		QStringList extracted;
+		bool ok = false;
+	};
+	qint64 total = 0;
+	for (auto &info: infos)
+	{
+		if (info.name.startsWith(subdir))
+		{
+			total += info.uncompressedSize;
+		}
+	}
+	const qint64 chunkBytes = std::max<qint64>(total / (QThreadPool::globalInstance()->maxThreadCount() * 4), 1);
+	QVector<Chunk> chunks;
+	{
+		Chunk chunk;
+		qint64 bytes = 0;
+		for (int i = 0; i < infos.size(); i++)
+		{
+			chunk.count++;
+			if (infos[i].name.startsWith(subdir))
+			{
+				bytes += infos[i].uncompressedSize;
+			}
+			if (bytes >= chunkBytes)
+			{
+				chunks.append(chunk);
+				chunk = Chunk();
+				chunk.first = i + 1;
+				bytes = 0;
+			}
+		}
+		if (chunk.count)
+		{
+			chunks.append(chunk);
+		}
+	}
+
+	QDir directory(target);
+	std::atomic<qint64> done(0);
+	auto extractChunk = [&](Chunk &chunk)
+	{
+		// every thread needs its own handle, a QuaZip has only one current file
+		QuaZip zip(archivePath);
+		if (!zip.open(QuaZip::mdUnzip) || !zip.goToFirstFile())
+		{
+			return;
+		}
+		for (int i = 0; i < chunk.first; i++)
+		{
+			if (!zip.goToNextFile())
+			{
+				return;
+			}
+		}
+		QuaZipFile file(&zip);
+		QByteArray buffer;
+		for (int i = chunk.first; i < chunk.first + chunk.count; i++)
+		{
+			if (i != chunk.first && !zip.goToNextFile())
+			{
+				return;
+			}
+			const auto &info = infos[i];
+			QString name = info.name;
+			if (!name.startsWith(subdir))
+			{
+				continue;
+			}
+			name.remove(0, subdir.size());
+			QString absFilePath = directory.absoluteFilePath(name);
+			bool isDir = name.isEmpty() || name.endsWith('/');
+			if (isDir)
+			{
+				if (!directory.mkpath(absFilePath))
+				{
+					qCritical() << "Failed to create folder" << absFilePath;
+					return;
+				}
+			}
+			else
+			{
+				if (!FS::ensureFilePathExists(absFilePath))
+				{
+					qCritical() << "Failed to create folder for" << absFilePath;
+					return;
+				}
+				QFile out(absFilePath);
+				if (!file.open(QIODevice::ReadOnly))
+				{
+					qCritical() << "Failed to open" << info.name << "in" << archivePath;
+					return;
+				}
+				if (!out.open(QIODevice::WriteOnly))
+				{
+					qCritical() << "Failed to open" << absFilePath << "for writing";
+					file.close();
+					return;
+				}
+				buffer.resize(256 * 1024);
+				qint64 read;
+				while ((read = file.read(buffer.data(), buffer.size())) > 0)
+				{
+					if (out.write(buffer.constData(), read) != read)
+					{
+						break;
+					}
+				}
+				// closing checks the CRC
+				file.close();
+				out.close();
+				if (read != 0 || file.getZipError() != 0 || out.error() != QFile::NoError)
+				{
+					qCritical() << "Failed to extract" << info.name << "to" << absFilePath;
+					chunk.extracted.append(absFilePath);
+					return;
+				}
+			}
+			// archives made on Windows store no permissions - keep what the file was created with then
+			QFileDevice::Permissions permissions = info.getPermissions();
+			if (permissions == 0)
+			{
+				permissions = QFile::permissions(absFilePath);
+			}
+			permissions |= QFileDevice::ReadUser | QFileDevice::WriteUser;
+			if (isDir)
+			{
+				permissions |= QFileDevice::ExeUser;
+			}
+			if (!QFile::setPermissions(absFilePath, permissions))
+			{
+				qWarning() << "Could not set permissions of" << absFilePath;
+			}
+			chunk.extracted.append(absFilePath);
+			qint64 count = done.fetch_add(info.uncompressedSize) + info.uncompressedSize;
+			if (progress)
+			{
+				progress(count, total);
+			}
+		}
+		chunk.ok = true;
+	};
+	QtConcurrent::blockingMap(chunks, extractChunk);
+
+	QStringList extracted;
+	bool ok = true;
+	for (auto &chunk: chunks)
+	{
+		ok &= chunk.ok;
+		extracted.append(chunk.extracted);
+	}
+	if (!ok)
+	{
+		JlCompress::removeFile(extracted);
+		return QStringList();
+	}
+	return extracted;
+}
+
 // ours
 QStringList MMCZip::extractDir(QString fileCompressed, QString dir)
 {
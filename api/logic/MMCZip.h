@@ -18,6 +18,7 @@
 #include <QString>
 #include <QFileInfo>
 #include <QSet>
+#include <QMap>
 #include "minecraft/Mod.h"
 #include <functional>
 
@@ -30,12 +31,16 @@ namespace MMCZip
 
 	/**
 	 * Merge two zip files, using a filter function
+	 *
+	 * Entries are copied still compressed, with their CRC, sizes and timestamps.
 	 */
 	bool MULTIMC_LOGIC_EXPORT mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained,
 											const JlCompress::FilterFunction filter = nullptr);
 
 	/**
 	 * take a source jar, add mods to it, resulting in target jar
+	 *
+	 * Only folder and single file mods have to be compressed, the rest is copied from the source zips.
 	 */
 	bool MULTIMC_LOGIC_EXPORT createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod>& mods);
 
@@ -46,6 +51,14 @@ namespace MMCZip
 	 */
 	QString MULTIMC_LOGIC_EXPORT findFolderOfFileInZip(QuaZip * zip, const QString & what, const QString &root = QString(""));
 
+	/**
+	 * Find where files with the given names are in an archive, reading its central directory only once.
+	 * If a name is in several places, the least nested one wins (the first one in the archive on ties).
+	 *
+	 * \return for every name found, the path prefix where it is ("" for the root, otherwise ending with '/')
+	 */
+	QMap<QString, QString> MULTIMC_LOGIC_EXPORT findFoldersOfFilesInZip(QuaZip * zip, const QStringList & what);
+
 	/**
 	 * Find a multiple files of the same name in archive by file name
 	 * If a file is found in a path, no deeper paths are searched
@@ -59,6 +72,18 @@ namespace MMCZip
 	 */
 	QStringList MULTIMC_LOGIC_EXPORT extractSubDir(QuaZip *zip, const QString & subdir, const QString &target);
 
+	/**
+	 * Extract a subdirectory from an archive on several threads, each reading the archive through its own handle.
+	 *
+	 * Extracted files get the permissions stored in the archive, plus read and write (folders also execute)
+	 * for the current user.
+	 *
+	 * \param progress called from the worker threads with the number of bytes extracted so far and the total
+	 * \return the list of the full paths of the files extracted, empty on failure
+	 */
+	QStringList MULTIMC_LOGIC_EXPORT extractSubDirParallel(const QString & archivePath, const QString & subdir, const QString &target,
+														   const std::function<void(qint64, qint64)> & progress = nullptr);
+
 	/**
 	 * Extract a whole archive.
 	 *
@@ -0,0 +1,114 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QMutex>
+#include <QMutexLocker>
+#include "TestUtil.h"
+
+#include "MMCZip.h"
+#include "FileSystem.h"
+#include <quazipfile.h>
+#include <quazipnewinfo.h>
+#include <algorithm>
+
+class MMCZipTest : public QObject
+{
+	Q_OBJECT
+private:
+	static QByteArray contentOf(int i)
+	{
+		return QByteArray::number(i).repeated(i * 37 % 5000 + 1);
+	}
+	static bool addFile(QuaZip &zip, const QString &name, const QByteArray &data, QFileDevice::Permissions permissions = 0)
+	{
+		QuaZipNewInfo info(name);
+		if (permissions)
+		{
+			info.setPermissions(permissions);
+		}
+		QuaZipFile file(&zip);
+		if (!file.open(QIODevice::WriteOnly, info))
+		{
+			return false;
+		}
+		bool ok = file.write(data) == data.size();
+		file.close();
+		return ok && file.getZipError() == 0;
+	}
+	static bool createPack(const QString &path, int files)
+	{
+		QuaZip zip(path);
+		if (!zip.open(QuaZip::mdCreate))
+		{
+			return false;
+		}
+		bool ok = true;
+		ok &= addFile(zip, "extra/deeper/instance.cfg", "InstanceType=OneSix\n");
+		ok &= addFile(zip, "pack/instance.cfg", "InstanceType=OneSix\nname=Pack\n");
+		ok &= addFile(zip, "pack/minecraft/config/readonly.cfg", "locked", QFileDevice::ReadOwner);
+		for (int i = 0; i < files; i++)
+		{
+			ok &= addFile(zip, QString("pack/minecraft/mods/mod%1.jar").arg(i), contentOf(i));
+		}
+		zip.close();
+		return ok && zip.getZipError() == 0;
+	}
+
+private
+slots:
+	void test_findFolders()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "pack.zip");
+		QVERIFY(createPack(path, 3));
+		QuaZip zip(path);
+		QVERIFY(zip.open(QuaZip::mdUnzip));
+		auto found = MMCZip::findFoldersOfFilesInZip(&zip, {"instance.cfg", "manifest.json", "mod1.jar"});
+		QCOMPARE(found.size(), 2);
+		// the least nested one wins, not the first one
+		QCOMPARE(found["instance.cfg"], QString("pack/"));
+		QCOMPARE(found["mod1.jar"], QString("pack/minecraft/mods/"));
+		QVERIFY(!found.contains("manifest.json"));
+	}
+
+	void test_extractParallel()
+	{
+		const int files = 500;
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "pack.zip");
+		QVERIFY(createPack(path, files));
+		auto target = FS::PathCombine(dir.path(), "out");
+
+		qint64 lastDone = 0;
+		qint64 lastTotal = 0;
+		QMutex progressLock;
+		auto progress = [&](qint64 done, qint64 total)
+		{
+			QMutexLocker locker(&progressLock);
+			lastDone = std::max(lastDone, done);
+			lastTotal = total;
+		};
+		auto extracted = MMCZip::extractSubDirParallel(path, "pack/", target, progress);
+		QCOMPARE(extracted.size(), files + 2);
+		QCOMPARE(lastDone, lastTotal);
+
+		QVERIFY(!QFile::exists(FS::PathCombine(target, "extra")));
+		QCOMPARE(FS::read(FS::PathCombine(target, "instance.cfg")), QByteArray("InstanceType=OneSix\nname=Pack\n"));
+		for (int i = 0; i < files; i++)
+		{
+			auto modPath = FS::PathCombine(target, "minecraft", "mods", QString("mod%1.jar").arg(i));
+			QCOMPARE(FS::read(modPath), contentOf(i));
+		}
+		// stored permissions are kept, but the user can always change the files
+		QVERIFY(QFileInfo(FS::PathCombine(target, "minecraft", "config", "readonly.cfg")).isWritable());
+	}
+
+	void test_extractMissing()
+	{
+		QTemporaryDir dir;
+		QVERIFY(MMCZip::extractSubDirParallel(FS::PathCombine(dir.path(), "nothing.zip"), "", dir.path()).isEmpty());
+	}
+};
+
+QTEST_GUILESS_MAIN(MMCZipTest)
+
+#include "MMCZip_test.moc"
@@ -26,8 +26,47 @@
 #include <QRegularExpression>
 #include <QCoreApplication>
 #include <QStandardPaths>
+#include <QtConcurrentRun>
 #include <assert.h>
 
+namespace {
+// smaller runs of log lines are processed right away, larger ones on the thread pool
+const int asyncLogThreshold = 64;
+
+/*
+ * Everything that happens to a log line before it gets to the log model.
+ * Runs on a worker thread, so it only touches what it was given.
+ */
+LogModel::Batch processLines(const QList<QPair<QStringList, MessageLevel::Enum>> &input, InstancePtr instance,
+							 std::shared_ptr<const LogCensor> censor)
+{
+	LogModel::Batch batch;
+	for (auto &run: input)
+	{
+		for (auto line: run.first)
+		{
+			auto level = run.second;
+			// if the launcher part set a log level, use it
+			auto innerLevel = MessageLevel::fromLine(line);
+			if(innerLevel != MessageLevel::Unknown)
+			{
+				level = innerLevel;
+			}
+
+			// If the level is still undetermined, guess level
+			if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown)
+			{
+				level = instance->guessLevel(line, level);
+			}
+
+			// censor private user info
+			batch.add(level, censor->censor(line));
+		}
+	}
+	return batch;
+}
+}
+
 void LaunchTask::init()
 {
 	m_instance->setRunning(true);
@@ -40,8 +79,15 @@ std::shared_ptr<LaunchTask> LaunchTask::create(InstancePtr inst)
 	return proc;
 }
 
-LaunchTask::LaunchTask(InstancePtr instance): m_instance(instance)
+LaunchTask::LaunchTask(InstancePtr instance): m_instance(instance), m_censor(std::make_shared<const LogCensor>())
 {
+	connect(&m_logWatcher, &QFutureWatcher<LogModel::Batch>::finished, this, &LaunchTask::logBatchReady);
+}
+
+LaunchTask::~LaunchTask()
+{
+	// the batch in flight holds a reference to the instance, don't let it go on a worker thread
+	flushLog();
 }
 
 void LaunchTask::appendStep(std::shared_ptr<LaunchStep> step)
@@ -127,18 +173,12 @@ void LaunchTask::onProgressReportingRequested()
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-	m_censorFilter = filter;
+	m_censor = std::make_shared<const LogCensor>(filter);
 }
 
 QString LaunchTask::censorPrivateInfo(QString in)
 {
-	auto iter = m_censorFilter.begin();
-	while (iter != m_censorFilter.end())
-	{
-		in.replace(iter.key(), iter.value());
-		iter++;
-	}
-	return in;
+	return m_censor->censor(in);
 }
 
 void LaunchTask::proceed()
@@ -211,6 +251,11 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
 		m_logModel.reset(new LogModel());
 		m_logModel->setMaxLines(m_instance->getConsoleMaxLines());
 		m_logModel->setStopOnOverflow(m_instance->shouldStopOnConsoleOverflow());
+		// unless asked to stop at the line limit, keep the whole log and only apply the limit to what is kept in memory
+		if(!m_instance->shouldStopOnConsoleOverflow())
+		{
+			m_logModel->setSpillToDisk(true);
+		}
 		// FIXME: should this really be here?
 		m_logModel->setOverflowMessage(tr("MultiMC stopped watching the game log because the log length surpassed %1 lines.\n"
 			"You may have to fix your mods because the game is still logging to files and"
@@ -221,42 +266,75 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
 
 void LaunchTask::onLogLines(const QStringList &lines, MessageLevel::Enum defaultLevel)
 {
-	for (auto & line: lines)
-	{
-		onLogLine(line, defaultLevel);
-	}
+	m_pendingLog.append(qMakePair(lines, defaultLevel));
+	processLogLines();
 }
 
 void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
 {
-	// if the launcher part set a log level, use it
-	auto innerLevel = MessageLevel::fromLine(line);
-	if(innerLevel != MessageLevel::Unknown)
+	onLogLines(QStringList{line}, level);
+}
+
+void LaunchTask::processLogLines()
+{
+	// one batch at a time, the lines have to arrive in order
+	if(m_logBatchRunning || m_pendingLog.isEmpty())
 	{
-		level = innerLevel;
+		return;
 	}
-
-	// If the level is still undetermined, guess level
-	if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown)
+	int count = 0;
+	for(auto &run: m_pendingLog)
 	{
-		level = m_instance->guessLevel(line, level);
+		count += run.first.size();
+	}
+	QList<QPair<QStringList, MessageLevel::Enum>> input;
+	input.swap(m_pendingLog);
+	if(count < asyncLogThreshold)
+	{
+		getLogModel()->append(processLines(input, m_instance, m_censor));
+		return;
 	}
+	m_logBatchRunning = true;
+	m_logWatcher.setFuture(QtConcurrent::run(processLines, input, m_instance, m_censor));
+}
 
-	// censor private user info
-	line = censorPrivateInfo(line);
+void LaunchTask::logBatchReady()
+{
+	// flushLog() got to it first
+	if(!m_logBatchRunning)
+	{
+		return;
+	}
+	m_logBatchRunning = false;
+	getLogModel()->append(m_logWatcher.result());
+	processLogLines();
+}
 
-	auto &model = *getLogModel();
-	model.append(level, line);
+void LaunchTask::flushLog()
+{
+	if(m_logBatchRunning)
+	{
+		m_logWatcher.waitForFinished();
+		m_logBatchRunning = false;
+		getLogModel()->append(m_logWatcher.result());
+	}
+	if(!m_pendingLog.isEmpty())
+	{
+		getLogModel()->append(processLines(m_pendingLog, m_instance, m_censor));
+		m_pendingLog.clear();
+	}
 }
 
 void LaunchTask::emitSucceeded()
 {
+	flushLog();
 	m_instance->setRunning(false);
 	Task::emitSucceeded();
 }
 
 void LaunchTask::emitFailed(QString reason)
 {
+	flushLog();
 	m_instance->setRunning(false);
 	m_instance->setCrashed(true);
 	Task::emitFailed(reason);
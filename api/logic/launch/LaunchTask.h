@@ -17,8 +17,10 @@
 
 #pragma once
 #include <QProcess>
+#include <QFutureWatcher>
 #include <QObjectPtr.h>
 #include "LogModel.h"
+#include "LogCensor.h"
 #include "BaseInstance.h"
 #include "MessageLevel.h"
 #include "LoggedProcess.h"
@@ -46,7 +48,7 @@ public:
 
 public: /* methods */
 	static std::shared_ptr<LaunchTask> create(InstancePtr inst);
-	virtual ~LaunchTask() {};
+	virtual ~LaunchTask();
 
 	void appendStep(std::shared_ptr<LaunchStep> step);
 	void prependStep(std::shared_ptr<LaunchStep> step);
@@ -111,15 +113,26 @@ public slots:
 	void onStepFinished();
 	void onProgressReportingRequested();
 
+private slots:
+	void logBatchReady();
+
 private: /*methods */
 	void finalizeSteps(bool successful, const QString & error);
+	void processLogLines();
+	void flushLog();
 
 protected: /* data */
 	InstancePtr m_instance;
 	shared_qobject_ptr<LogModel> m_logModel;
 	QList <std::shared_ptr<LaunchStep>> m_steps;
-	QMap<QString, QString> m_censorFilter;
+	std::shared_ptr<const LogCensor> m_censor;
 	int currentStep = -1;
 	State state = NotStarted;
 	qint64 m_pid = -1;
+
+private: /* data */
+	// log lines waiting to be classified, in the order they came in
+	QList<QPair<QStringList, MessageLevel::Enum>> m_pendingLog;
+	QFutureWatcher<LogModel::Batch> m_logWatcher;
+	bool m_logBatchRunning = false;
 };
@@ -0,0 +1,175 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LogCensor.h"
+
+#include <QQueue>
+#include <QVarLengthArray>
+
+LogCensor::LogCensor(const QMap<QString, QString> &filter)
+{
+	m_asciiClass.fill(0, 128);
+	QStringList secrets;
+	for (auto iter = filter.begin(); iter != filter.end(); iter++)
+	{
+		if (iter.key().isEmpty())
+			continue;
+		secrets.append(iter.key());
+		m_replacements.append(iter.value());
+		for (auto c : iter.key())
+		{
+			ushort code = c.unicode();
+			if (classOf(code) == 0)
+			{
+				if (code < 128)
+					m_asciiClass[code] = m_classes;
+				else
+					m_otherClass[code] = m_classes;
+				m_classes++;
+			}
+		}
+	}
+	if (secrets.isEmpty())
+	{
+		return;
+	}
+
+	// build the trie, -1 marks transitions that don't exist yet
+	auto addState = [this]()
+	{
+		m_transitions.insert(m_transitions.size(), m_classes, -1);
+		m_output.append(-1);
+		m_nextOutput.append(-1);
+		m_matchLength.append(0);
+		m_matchReplacement.append(-1);
+		return m_output.size() - 1;
+	};
+	addState();
+	for (int i = 0; i < secrets.size(); i++)
+	{
+		int state = 0;
+		for (auto c : secrets[i])
+		{
+			int index = state * m_classes + classOf(c.unicode());
+			if (m_transitions[index] == -1)
+			{
+				int next = addState();
+				m_transitions[index] = next;
+			}
+			state = m_transitions[index];
+		}
+		m_output[state] = state;
+		m_matchLength[state] = secrets[i].size();
+		m_matchReplacement[state] = i;
+	}
+
+	// turn it into an automaton, breadth first so the fallback of each state is done before the state
+	QVector<int> fallback(m_output.size(), 0);
+	QQueue<int> queue;
+	for (int c = 0; c < m_classes; c++)
+	{
+		int &next = m_transitions[c];
+		if (next == -1)
+		{
+			next = 0;
+		}
+		else
+		{
+			queue.enqueue(next);
+		}
+	}
+	while (!queue.isEmpty())
+	{
+		int state = queue.dequeue();
+		int fallbackRow = fallback[state] * m_classes;
+		for (int c = 0; c < m_classes; c++)
+		{
+			int &next = m_transitions[state * m_classes + c];
+			if (next == -1)
+			{
+				next = m_transitions[fallbackRow + c];
+				continue;
+			}
+			fallback[next] = m_transitions[fallbackRow + c];
+			// shorter secrets ending here are the ones ending in the fallback
+			if (m_output[next] == -1)
+			{
+				m_output[next] = m_output[fallback[next]];
+			}
+			else
+			{
+				m_nextOutput[next] = m_output[fallback[next]];
+			}
+			queue.enqueue(next);
+		}
+	}
+}
+
+QString LogCensor::censor(const QString &in) const
+{
+	if (isEmpty())
+	{
+		return in;
+	}
+	struct Match
+	{
+		int start;
+		int length;
+		int replacement;
+	};
+	QVarLengthArray<Match, 8> matches;
+	const QChar *data = in.constData();
+	const int size = in.size();
+	int state = 0;
+	for (int i = 0; i < size; i++)
+	{
+		state = m_transitions[state * m_classes + classOf(data[i].unicode())];
+		// longest first, a shorter one only matters if the longer ones can't be used
+		for (int output = m_output[state]; output != -1; output = m_nextOutput[output])
+		{
+			Match match{i - m_matchLength[output] + 1, m_matchLength[output], m_matchReplacement[output]};
+			// a match swallows the ones it covers
+			int keep = matches.size();
+			while (keep > 0 && match.start <= matches[keep - 1].start)
+			{
+				keep--;
+			}
+			// but when it only overlaps an earlier one, the earlier one wins
+			if (keep > 0 && match.start < matches[keep - 1].start + matches[keep - 1].length)
+			{
+				continue;
+			}
+			matches.resize(keep);
+			matches.append(match);
+			break;
+		}
+	}
+	if (matches.isEmpty())
+	{
+		return in;
+	}
+
+	QString out;
+	out.reserve(size);
+	int position = 0;
+	for (auto &match : matches)
+	{
+		out.append(data + position, match.start - position);
+		out.append(m_replacements[match.replacement]);
+		position = match.start + match.length;
+	}
+	out.append(data + position, size - position);
+	return out;
+}
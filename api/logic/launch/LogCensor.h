@@ -0,0 +1,72 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+
+#include "multimc_logic_export.h"
+
+/*
+ * Replaces every occurrence of a set of secrets in a line of text with their placeholders.
+ *
+ * The secrets are compiled into an Aho-Corasick automaton once, after that a line is censored
+ * in a single pass no matter how many secrets there are. Where secrets overlap, the one that starts
+ * first wins, and of those starting at the same place, the longest. The part of a losing secret
+ * that sticks out past the winner stays visible: "abcdx" with secrets "abc" and "cdx" leaves "dx".
+ *
+ * A built censor is immutable and can be shared between threads.
+ */
+class MULTIMC_LOGIC_EXPORT LogCensor
+{
+public:
+	LogCensor() = default;
+	explicit LogCensor(const QMap<QString, QString> &filter);
+
+	/// Censor a line. When there is nothing to censor, the line is returned as is, without allocating anything.
+	QString censor(const QString &in) const;
+
+	bool isEmpty() const
+	{
+		return m_replacements.isEmpty();
+	}
+
+private:
+	int classOf(ushort c) const
+	{
+		return c < 128 ? m_asciiClass[c] : m_otherClass.value(c, 0);
+	}
+
+private:
+	// characters that appear in the secrets get a class, everything else is class 0
+	QVector<int> m_asciiClass;
+	QHash<ushort, int> m_otherClass;
+	int m_classes = 1;
+
+	// transitions of the automaton, one row of m_classes per state, state 0 is the root
+	QVector<int> m_transitions;
+	// per state, the state where the longest secret ending here ends, -1 if none
+	QVector<int> m_output;
+	// for states where a secret ends, the state of the next shorter secret ending at the same place, or -1
+	QVector<int> m_nextOutput;
+	// for states where a secret ends, its length and the index of its replacement
+	QVector<int> m_matchLength;
+	QVector<int> m_matchReplacement;
+	QStringList m_replacements;
+};
@@ -0,0 +1,88 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "launch/LogCensor.h"
+
+class LogCensorTest : public QObject
+{
+	Q_OBJECT
+private:
+	static QMap<QString, QString> sessionFilter()
+	{
+		return {
+			{"3f1e0c6a9b2d4e8f8a7b6c5d4e3f2a1b", "<ACCESS TOKEN>"},
+			{"9d8c7b6a5f4e3d2c1b0a9f8e7d6c5b4a", "<CLIENT TOKEN>"},
+			{"0123456789abcdef0123456789abcdef", "<PROFILE ID>"},
+			{"Player123", "<PROFILE NAME>"},
+			{"textures", "<TEXTURES>"},
+		};
+	}
+
+private
+slots:
+	void test_censor_data()
+	{
+		QTest::addColumn<QString>("line");
+		QTest::addColumn<QString>("expected");
+		QTest::newRow("nothing") << "[12:01:36] [Client thread/INFO]: LWJGL Version: 2.9.1"
+			<< "[12:01:36] [Client thread/INFO]: LWJGL Version: 2.9.1";
+		QTest::newRow("empty") << "" << "";
+		QTest::newRow("name") << "[12:01:36] [Client thread/INFO]: Setting user: Player123"
+			<< "[12:01:36] [Client thread/INFO]: Setting user: <PROFILE NAME>";
+		QTest::newRow("several") << "--username Player123 --uuid 0123456789abcdef0123456789abcdef --accessToken 3f1e0c6a9b2d4e8f8a7b6c5d4e3f2a1b"
+			<< "--username <PROFILE NAME> --uuid <PROFILE ID> --accessToken <ACCESS TOKEN>";
+		QTest::newRow("repeated") << "Player123Player123 Player123" << "<PROFILE NAME><PROFILE NAME> <PROFILE NAME>";
+		QTest::newRow("edges") << "Player123 in the middle Player123" << "<PROFILE NAME> in the middle <PROFILE NAME>";
+		QTest::newRow("partial") << "Player12 3f1e0c6a9b2d Player1234" << "Player12 3f1e0c6a9b2d <PROFILE NAME>4";
+		QTest::newRow("unicode") << QString::fromUtf8("Hráč Player123 připojen") << QString::fromUtf8("Hráč <PROFILE NAME> připojen");
+	}
+	void test_censor()
+	{
+		QFETCH(QString, line);
+		QFETCH(QString, expected);
+		LogCensor censor(sessionFilter());
+		QCOMPARE(censor.censor(line), expected);
+	}
+
+	void test_noMatchDoesNotCopy()
+	{
+		LogCensor censor(sessionFilter());
+		QString line = "[12:01:36] [Client thread/INFO]: LWJGL Version: 2.9.1";
+		QString out = censor.censor(line);
+		QCOMPARE(out.constData(), line.constData());
+	}
+
+	void test_empty()
+	{
+		LogCensor censor;
+		QVERIFY(censor.isEmpty());
+		QCOMPARE(censor.censor("Player123"), QString("Player123"));
+		LogCensor withEmptyKey(QMap<QString, QString>{{"", "<NOTHING>"}});
+		QVERIFY(withEmptyKey.isEmpty());
+		QCOMPARE(withEmptyKey.censor("abc"), QString("abc"));
+	}
+
+	void test_overlapping()
+	{
+		LogCensor censor(QMap<QString, QString>{
+			{"token:abc:def", "<SESSION ID>"},
+			{"abc", "<ACCESS TOKEN>"},
+			{"def", "<PROFILE ID>"},
+			{"cdx", "<OTHER>"},
+			{"he", "<HE>"},
+			{"she", "<SHE>"},
+			{"hers", "<HERS>"},
+		});
+		// the longest match wins over the ones it contains
+		QCOMPARE(censor.censor("session token:abc:def"), QString("session <SESSION ID>"));
+		QCOMPARE(censor.censor("token:abc:xyz"), QString("token:<ACCESS TOKEN>:xyz"));
+		// overlapping secrets, the first one wins and the shorter ones after it still count
+		QCOMPARE(censor.censor("abcdx def"), QString("<ACCESS TOKEN>dx <PROFILE ID>"));
+		QCOMPARE(censor.censor("ushers"), QString("u<SHE>rs"));
+		QCOMPARE(censor.censor("hers"), QString("<HERS>"));
+	}
+};
+
+QTEST_GUILESS_MAIN(LogCensorTest)
+
+#include "LogCensor_test.moc"
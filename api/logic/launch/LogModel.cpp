@@ -1,67 +1,223 @@
 #include "LogModel.h"
 
+#include <QBuffer>
+
+namespace {
+// lines are packed into chunks of this size, a chunk is released when its last line goes
+const int chunkSize = 64 * 1024;
+}
+
+void LogModel::Batch::add(MessageLevel::Enum level, const QString& line)
+{
+	auto utf8 = line.toUtf8();
+	m_text.append(utf8);
+	m_lines.append({level, utf8.size()});
+}
+
 LogModel::LogModel(QObject *parent):QAbstractListModel(parent)
 {
 	m_content.resize(m_maxLines);
 }
 
+LogModel::~LogModel()
+{
+}
+
 int LogModel::rowCount(const QModelIndex &parent) const
 {
 	if (parent.isValid())
 		return 0;
 
-	return m_numLines;
+	return storedLines() + m_numLines;
 }
 
 QVariant LogModel::data(const QModelIndex &index, int role) const
 {
-	if (index.row() < 0 || index.row() >= m_numLines)
+	if (index.row() < 0 || index.row() >= rowCount())
 		return QVariant();
 
 	auto row = index.row();
-	auto realRow = (row + m_firstLine) % m_maxLines;
 	if (role == Qt::DisplayRole || role == Qt::EditRole)
 	{
-		return m_content[realRow].line;
+		return lineAt(row);
 	}
 	if(role == LevelRole)
 	{
-		return m_content[realRow].level;
+		return levelAt(row);
 	}
 
 	return QVariant();
 }
 
+QString LogModel::lineAt(int row) const
+{
+	int stored = storedLines();
+	if(row < stored)
+	{
+		return QString::fromUtf8(m_store->text(row));
+	}
+	const entry & line = m_content[(row - stored + m_firstLine) % m_maxLines];
+	const QByteArray & chunk = m_chunks[line.chunk - m_firstChunk];
+	return QString::fromUtf8(chunk.constData() + line.offset, line.length);
+}
+
+QByteArray LogModel::textAt(int row) const
+{
+	int stored = storedLines();
+	if(row < stored)
+	{
+		return m_store->text(row);
+	}
+	const entry & line = m_content[(row - stored + m_firstLine) % m_maxLines];
+	const QByteArray & chunk = m_chunks[line.chunk - m_firstChunk];
+	return QByteArray::fromRawData(chunk.constData() + line.offset, line.length);
+}
+
+MessageLevel::Enum LogModel::levelAt(int row) const
+{
+	int stored = storedLines();
+	if(row < stored)
+	{
+		return m_store->level(row);
+	}
+	return m_content[(row - stored + m_firstLine) % m_maxLines].level;
+}
+
+void LogModel::store(int slot, MessageLevel::Enum level, const char* text, int length)
+{
+	if(m_chunks.isEmpty() || (m_chunks.last().size() + length > chunkSize && !m_chunks.last().isEmpty()))
+	{
+		QByteArray chunk;
+		chunk.reserve(qMax(chunkSize, length));
+		m_chunks.append(chunk);
+	}
+	QByteArray & chunk = m_chunks.last();
+	entry & line = m_content[slot];
+	line.chunk = m_firstChunk + m_chunks.size() - 1;
+	line.offset = chunk.size();
+	line.length = length;
+	line.level = level;
+	chunk.append(text, length);
+}
+
+void LogModel::spill(int count)
+{
+	for(int i = 0; i < count; i++)
+	{
+		const entry & line = m_content[m_firstLine];
+		const QByteArray & chunk = m_chunks[line.chunk - m_firstChunk];
+		m_store->append(line.level, chunk.constData() + line.offset, line.length);
+		m_firstLine = (m_firstLine + 1) % m_maxLines;
+		m_numLines --;
+	}
+}
+
+void LogModel::dropUnusedChunks()
+{
+	if(m_numLines == 0)
+	{
+		m_firstChunk += m_chunks.size();
+		m_chunks.clear();
+		return;
+	}
+	// lines are stored in order, so everything before the chunk of the oldest line is garbage
+	int oldest = m_content[m_firstLine].chunk;
+	while(m_firstChunk < oldest)
+	{
+		m_chunks.removeFirst();
+		m_firstChunk++;
+	}
+}
+
 void LogModel::append(MessageLevel::Enum level, QString line)
 {
-	if(m_suspended)
+	Batch batch;
+	batch.add(level, line);
+	append(batch);
+}
+
+void LogModel::append(const Batch& batch)
+{
+	if(m_suspended || batch.isEmpty())
 	{
 		return;
 	}
-	int lineNum = (m_firstLine + m_numLines) % m_maxLines;
-	// overflow
-	if(m_numLines == m_maxLines)
+	int count = batch.size();
+	// lines at the start of the batch that would be pushed out by the rest of it anyway
+	int skip = 0;
+	bool overflow = false;
+	if(m_stopOnOverflow && !m_store)
 	{
-		if(m_stopOnOverflow)
+		int room = m_maxLines - m_numLines;
+		if(room <= 0)
 		{
 			// nothing more to do, the buffer is full
 			return;
 		}
-		beginRemoveRows(QModelIndex(), 0, 0);
-		m_firstLine = (m_firstLine + 1) % m_maxLines;
-		m_numLines --;
-		endRemoveRows();
+		if(count >= room)
+		{
+			// the last line that fits is replaced by the overflow message
+			count = room;
+			overflow = true;
+		}
 	}
-	else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow)
+	else if(count > m_maxLines)
 	{
-		level = MessageLevel::Fatal;
-		line = m_overflowMessage;
+		skip = count - m_maxLines;
+		count = m_maxLines;
+	}
+
+	int excess = m_numLines + count - m_maxLines;
+	const char * text = batch.m_text.constData();
+	if(m_store)
+	{
+		// nothing is removed, the oldest lines just move to the disk
+		int first = rowCount();
+		beginInsertRows(QModelIndex(), first, first + skip + count - 1);
+		if(excess > 0)
+		{
+			spill(excess);
+		}
+		for(int i = 0; i < skip; i++)
+		{
+			const auto & line = batch.m_lines[i];
+			m_store->append(line.level, text, line.length);
+			text += line.length;
+		}
+	}
+	else
+	{
+		if(excess > 0)
+		{
+			beginRemoveRows(QModelIndex(), 0, excess - 1);
+			m_firstLine = (m_firstLine + excess) % m_maxLines;
+			m_numLines -= excess;
+			endRemoveRows();
+		}
+		for(int i = 0; i < skip; i++)
+		{
+			text += batch.m_lines[i].length;
+		}
+		beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+	}
+	for(int i = 0; i < count; i++)
+	{
+		int lineNum = (m_firstLine + m_numLines) % m_maxLines;
+		if(overflow && i == count - 1)
+		{
+			auto message = m_overflowMessage.toUtf8();
+			store(lineNum, MessageLevel::Fatal, message.constData(), message.size());
+		}
+		else
+		{
+			const auto & line = batch.m_lines[skip + i];
+			store(lineNum, line.level, text, line.length);
+			text += line.length;
+		}
+		m_numLines ++;
 	}
-	beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-	m_numLines ++;
-	m_content[lineNum].level = level;
-	m_content[lineNum].line = line;
 	endInsertRows();
+	dropUnusedChunks();
 }
 
 void LogModel::suspend(bool suspend)
@@ -74,20 +230,126 @@ void LogModel::clear()
 	beginResetModel();
 	m_firstLine = 0;
 	m_numLines = 0;
+	dropUnusedChunks();
+	if(m_store)
+	{
+		m_store->clear();
+	}
 	endResetModel();
 }
 
 QString LogModel::toPlainText()
 {
-	QString out;
-	out.reserve(m_numLines * 80);
-	for(int i = 0; i < m_numLines; i++)
+	QByteArray out;
+	QBuffer buffer(&out);
+	buffer.open(QIODevice::WriteOnly);
+	write(buffer);
+	return QString::fromUtf8(out);
+}
+
+bool LogModel::write(QIODevice& out)
+{
+	int rows = rowCount();
+	for(int i = 0; i < rows; i++)
+	{
+		auto text = textAt(i);
+		if(out.write(text) != text.size() || !out.putChar('\n'))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int LogModel::find(const QString& what, int from, bool reverse) const
+{
+	int rows = rowCount();
+	if(what.isEmpty() || !rows)
+	{
+		return -1;
+	}
+	LogMatcher matcher(what);
+	from = ((from % rows) + rows) % rows;
+	int row;
+	if(reverse)
+	{
+		// up from the line before 'from', then down from the end, ending with 'from' itself
+		row = findIn(matcher, 0, from, true);
+		if(row < 0)
+		{
+			row = findIn(matcher, from, rows, true);
+		}
+	}
+	else
+	{
+		// down from the line after 'from', then from the start, ending with 'from' itself
+		row = findIn(matcher, from + 1, rows, false);
+		if(row < 0)
+		{
+			row = findIn(matcher, 0, from + 1, false);
+		}
+	}
+	return row;
+}
+
+int LogModel::findIn(const LogMatcher& matcher, int begin, int end, bool reverse) const
+{
+	int stored = storedLines();
+	auto findInMemory = [&]()
+	{
+		int low = qMax(begin, stored);
+		for(int row = reverse ? end - 1 : low; reverse ? row >= low : row < end; reverse ? row-- : row++)
+		{
+			const entry & line = m_content[(row - stored + m_firstLine) % m_maxLines];
+			const QByteArray & chunk = m_chunks[line.chunk - m_firstChunk];
+			if(matcher.matches(chunk.constData() + line.offset, line.length))
+			{
+				return row;
+			}
+		}
+		return -1;
+	};
+	auto findInStore = [&]()
+	{
+		if(!m_store || begin >= stored)
+		{
+			return -1;
+		}
+		return m_store->find(matcher, begin, qMin(end, stored), reverse);
+	};
+	int row = reverse ? findInMemory() : findInStore();
+	if(row < 0)
+	{
+		row = reverse ? findInStore() : findInMemory();
+	}
+	return row;
+}
+
+bool LogModel::setSpillToDisk(bool spill)
+{
+	if(spill == bool(m_store))
+	{
+		return true;
+	}
+	if(spill)
 	{
-		QString & line = m_content[(m_firstLine + i) % m_maxLines].line;
-		out.append(line + '\n');
+		std::unique_ptr<LogStore> store(new LogStore());
+		if(!store->open())
+		{
+			return false;
+		}
+		m_store = std::move(store);
+		return true;
 	}
-	out.squeeze();
-	return out;
+	int stored = storedLines();
+	if(stored)
+	{
+		beginRemoveRows(QModelIndex(), 0, stored - 1);
+		m_store.reset();
+		endRemoveRows();
+	}
+	m_store.reset();
+	return true;
 }
 
 void LogModel::setMaxLines(int maxLines)
@@ -97,8 +359,14 @@ void LogModel::setMaxLines(int maxLines)
 	{
 		return;
 	}
+	// what doesn't fit any more goes to the disk, if it can
+	if(m_store && m_numLines > maxLines)
+	{
+		spill(m_numLines - maxLines);
+		dropUnusedChunks();
+	}
 	// if it all still fits in the buffer, just resize it
-	if(m_firstLine + m_numLines < m_maxLines)
+	if(m_firstLine + m_numLines < m_maxLines && m_firstLine + m_numLines <= maxLines)
 	{
 		m_maxLines = maxLines;
 		m_content.resize(maxLines);
@@ -115,6 +383,8 @@ void LogModel::setMaxLines(int maxLines)
 			newContent[i] = m_content[(m_firstLine + i) % m_maxLines];
 		}
 		m_content.swap(newContent);
+		m_firstLine = 0;
+		m_maxLines = maxLines;
 	}
 	else
 	{
@@ -125,12 +395,13 @@ void LogModel::setMaxLines(int maxLines)
 		{
 			newContent[i] = m_content[(m_firstLine + lead + i) % m_maxLines];
 		}
-		m_numLines = m_maxLines;
+		m_numLines = maxLines;
 		m_content.swap(newContent);
+		m_firstLine = 0;
+		m_maxLines = maxLines;
 		endRemoveRows();
+		dropUnusedChunks();
 	}
-	m_firstLine = 0;
-	m_maxLines = maxLines;
 }
 
 int LogModel::getMaxLines()
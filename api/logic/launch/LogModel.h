@@ -2,42 +2,108 @@
 
 #include <QAbstractListModel>
 #include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include <memory>
 #include "MessageLevel.h"
+#include "LogStore.h"
 
 #include <multimc_logic_export.h>
 
+class QIODevice;
+
 class MULTIMC_LOGIC_EXPORT LogModel : public QAbstractListModel
 {
 	Q_OBJECT
+public:
+	/**
+	 * A run of log lines, already encoded as UTF-8, that can be put together on any thread
+	 * and appended to the model with a single row insertion.
+	 */
+	class MULTIMC_LOGIC_EXPORT Batch
+	{
+	public:
+		void add(MessageLevel::Enum level, const QString & line);
+		int size() const
+		{
+			return m_lines.size();
+		}
+		bool isEmpty() const
+		{
+			return m_lines.isEmpty();
+		}
+
+	private:
+		friend class LogModel;
+		struct line
+		{
+			MessageLevel::Enum level;
+			int length;
+		};
+		QByteArray m_text;
+		QVector<line> m_lines;
+	};
+
 public:
 	explicit LogModel(QObject *parent = 0);
+	virtual ~LogModel();
 
 	int rowCount(const QModelIndex &parent = QModelIndex()) const;
 	QVariant data(const QModelIndex &index, int role) const;
 
 	void append(MessageLevel::Enum, QString line);
+	void append(const Batch & batch);
 	void clear();
 	void suspend(bool suspend);
 
 	QString toPlainText();
+	/// Write all of the log to a device as UTF-8 text, a line at a time
+	bool write(QIODevice & out);
+	/// Find the next line containing some text, case insensitive. Starts after 'from' and wraps around. Returns -1 if nothing matches.
+	int find(const QString & what, int from, bool reverse) const;
 
 	int getMaxLines();
 	void setMaxLines(int maxLines);
 	void setStopOnOverflow(bool stop);
 	void setOverflowMessage(const QString & overflowMessage);
 
+	/**
+	 * Keep lines that don't fit in memory in a compressed file instead of dropping them.
+	 * The limit on lines then only applies to memory and logging never stops on overflow.
+	 * Returns false if the file can't be created, in which case nothing changes.
+	 */
+	bool setSpillToDisk(bool spill);
+
 	enum Roles
 	{
 		LevelRole = Qt::UserRole
 	};
 
 private /* types */:
+	// a line of text is stored in one of the chunks, as UTF-8
 	struct entry
 	{
+		// serial number of the chunk the line lives in
+		int chunk;
+		int offset;
+		int length;
 		MessageLevel::Enum level;
-		QString line;
 	};
 
+private: /* methods */
+	QString lineAt(int row) const;
+	int findIn(const LogMatcher & matcher, int begin, int end, bool reverse) const;
+	QByteArray textAt(int row) const;
+	MessageLevel::Enum levelAt(int row) const;
+	void store(int slot, MessageLevel::Enum level, const char * text, int length);
+	void spill(int count);
+	void dropUnusedChunks();
+	int storedLines() const
+	{
+		return m_store ? m_store->size() : 0;
+	}
+
 private: /* data */
 	QVector <entry> m_content;
 	int m_maxLines = 1000;
@@ -49,6 +115,14 @@ private: /* data */
 	QString m_overflowMessage = "OVERFLOW";
 	bool m_suspended = false;
 
+	// text of the lines in the circular buffer, oldest chunk first
+	QList<QByteArray> m_chunks;
+	// serial number of the first chunk in m_chunks
+	int m_firstChunk = 0;
+
+	// lines older than the ones in the circular buffer, when spilling to disk
+	std::unique_ptr<LogStore> m_store;
+
 private:
 	Q_DISABLE_COPY(LogModel)
 };
@@ -0,0 +1,185 @@
+#include <QTest>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "launch/LogModel.h"
+
+class LogModelTest : public QObject
+{
+	Q_OBJECT
+private:
+	QStringList lines(LogModel &model)
+	{
+		QStringList out;
+		for(int i = 0; i < model.rowCount(); i++)
+		{
+			out.append(model.data(model.index(i), Qt::DisplayRole).toString());
+		}
+		return out;
+	}
+	LogModel::Batch batch(int from, int to)
+	{
+		LogModel::Batch out;
+		for(int i = from; i < to; i++)
+		{
+			out.add(i % 2 ? MessageLevel::Warning : MessageLevel::Message, QString("line %1").arg(i));
+		}
+		return out;
+	}
+	QStringList expected(int from, int to)
+	{
+		QStringList out;
+		for(int i = from; i < to; i++)
+		{
+			out.append(QString("line %1").arg(i));
+		}
+		return out;
+	}
+
+private
+slots:
+	void test_batchIsOneInsert()
+	{
+		LogModel model;
+		QSignalSpy inserts(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+		model.append(batch(0, 100));
+		QCOMPARE(inserts.size(), 1);
+		QCOMPARE(lines(model), expected(0, 100));
+		QCOMPARE(model.data(model.index(1), LogModel::LevelRole).toInt(), int(MessageLevel::Warning));
+	}
+	void test_unicode()
+	{
+		LogModel model;
+		QString line = QString::fromUtf8("Příliš žluťoučký kůň \xF0\x9F\x90\xB4");
+		model.append(MessageLevel::Message, line);
+		model.append(MessageLevel::Message, QString());
+		QCOMPARE(lines(model), QStringList({line, QString()}));
+	}
+	void test_findUnicode()
+	{
+		LogModel model;
+		model.setMaxLines(2);
+		QVERIFY(model.setSpillToDisk(true));
+		model.append(MessageLevel::Message, QString::fromUtf8("Ünïcödé ÄÖ"));
+		model.append(MessageLevel::Message, "plain");
+		model.append(MessageLevel::Message, QString::fromUtf8("NAÏVE"));
+		model.append(MessageLevel::Message, "last");
+		QCOMPARE(model.find(QString::fromUtf8("äö"), 3, false), 0);
+		QCOMPARE(model.find(QString::fromUtf8("naïve"), 0, false), 2);
+		QCOMPARE(model.find("PLAIN", 3, true), 1);
+		// ASCII text does not match the bytes of other characters
+		QCOMPARE(model.find("y", 3, false), -1);
+	}
+
+	void test_wraps()
+	{
+		LogModel model;
+		model.setMaxLines(50);
+		QSignalSpy removals(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+		for(int i = 0; i < 20; i++)
+		{
+			model.append(batch(i * 7, (i + 1) * 7));
+		}
+		QCOMPARE(lines(model), expected(140 - 50, 140));
+		QVERIFY(removals.size() > 0);
+
+		// a batch larger than the whole buffer keeps only its tail
+		model.append(batch(1000, 1200));
+		QCOMPARE(lines(model), expected(1150, 1200));
+		QCOMPARE(model.toPlainText(), expected(1150, 1200).join('\n') + '\n');
+	}
+	void test_stopOnOverflow()
+	{
+		LogModel model;
+		model.setMaxLines(10);
+		model.setStopOnOverflow(true);
+		model.setOverflowMessage("FULL");
+		model.append(batch(0, 4));
+		model.append(batch(4, 20));
+		model.append(batch(20, 30));
+		auto expect = expected(0, 9);
+		expect.append("FULL");
+		QCOMPARE(lines(model), expect);
+		QCOMPARE(model.data(model.index(9), LogModel::LevelRole).toInt(), int(MessageLevel::Fatal));
+	}
+	void test_setMaxLines()
+	{
+		LogModel model;
+		model.setMaxLines(10);
+		model.append(batch(0, 25));
+		model.setMaxLines(20);
+		QCOMPARE(lines(model), expected(15, 25));
+		model.append(batch(25, 30));
+		QCOMPARE(lines(model), expected(15, 30));
+		model.setMaxLines(5);
+		QCOMPARE(lines(model), expected(25, 30));
+		model.clear();
+		QCOMPARE(model.rowCount(), 0);
+		model.append(batch(0, 3));
+		QCOMPARE(lines(model), expected(0, 3));
+	}
+	void test_longRun()
+	{
+		// enough text to cycle through many chunks
+		LogModel model;
+		model.setMaxLines(100);
+		QString padding(1000, 'x');
+		for(int i = 0; i < 2000; i++)
+		{
+			model.append(MessageLevel::Message, QString::number(i) + padding);
+		}
+		QCOMPARE(model.rowCount(), 100);
+		QCOMPARE(model.data(model.index(0), Qt::DisplayRole).toString(), QString::number(1900) + padding);
+		QCOMPARE(model.data(model.index(99), Qt::DisplayRole).toString(), QString::number(1999) + padding);
+	}
+	void test_spillToDisk()
+	{
+		LogModel model;
+		model.setMaxLines(100);
+		model.setStopOnOverflow(true);
+		QVERIFY(model.setSpillToDisk(true));
+		QSignalSpy removals(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+		const int total = 20000;
+		for(int i = 0; i < total; i += 500)
+		{
+			model.append(batch(i, i + 500));
+		}
+		// a batch larger than what is kept in memory goes straight through
+		model.append(batch(total, total + 300));
+		QCOMPARE(model.rowCount(), total + 300);
+		QCOMPARE(removals.size(), 0);
+		for(int row: {0, 1, 4095, 4096, 4097, 12345, total - 1, total, total + 299})
+		{
+			QCOMPARE(model.data(model.index(row), Qt::DisplayRole).toString(), QString("line %1").arg(row));
+			QCOMPARE(model.data(model.index(row), LogModel::LevelRole).toInt(), int(row % 2 ? MessageLevel::Warning : MessageLevel::Message));
+		}
+		// going backwards through segments
+		for(int row = total + 299; row >= 0; row -= 997)
+		{
+			QCOMPARE(model.data(model.index(row), Qt::DisplayRole).toString(), QString("line %1").arg(row));
+		}
+
+		QCOMPARE(model.find("LINE 7", 100, false), 700);
+		QCOMPARE(model.find("line 7", 100, true), 79);
+		QCOMPARE(model.find("line 20299", 20299, false), 20299);
+		QCOMPARE(model.find("nothing like this", 0, false), -1);
+		// wraps around, in both directions
+		QCOMPARE(model.find("line 5", total + 200, false), 5);
+		QCOMPARE(model.find("line 20250", 5, true), 20250);
+
+		QCOMPARE(model.toPlainText(), expected(0, total + 300).join('\n') + '\n');
+
+		model.setMaxLines(10);
+		QCOMPARE(model.rowCount(), total + 300);
+		QCOMPARE(model.data(model.index(total + 289), Qt::DisplayRole).toString(), QString("line %1").arg(total + 289));
+
+		model.clear();
+		QCOMPARE(model.rowCount(), 0);
+		model.append(batch(0, 30));
+		QCOMPARE(lines(model), expected(0, 30));
+	}
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
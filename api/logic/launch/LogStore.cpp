@@ -0,0 +1,254 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LogStore.h"
+
+#include <QTemporaryFile>
+#include <QDir>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// a segment is sealed when it has this many lines or this much text, whichever comes first
+const int segmentLines = 4096;
+const int segmentText = 256 * 1024;
+// how many decompressed segments to keep
+const int cachedSegments = 4;
+
+/*
+ * A sealed segment, before compression:
+ * line count, then the end of each line in the text, then the level of each line, then the text.
+ */
+QByteArray pack(const QVector<quint32> &ends, const QVector<quint8> &levels, const QByteArray &text)
+{
+	quint32 count = ends.size();
+	QByteArray blob;
+	blob.reserve(sizeof(count) + count * (sizeof(quint32) + sizeof(quint8)) + text.size());
+	blob.append(reinterpret_cast<const char *>(&count), sizeof(count));
+	blob.append(reinterpret_cast<const char *>(ends.constData()), count * sizeof(quint32));
+	blob.append(reinterpret_cast<const char *>(levels.constData()), count * sizeof(quint8));
+	blob.append(text);
+	return blob;
+}
+
+bool unpack(const QByteArray &blob, QVector<quint32> &ends, QVector<quint8> &levels, QByteArray &text)
+{
+	quint32 count;
+	if (blob.size() < int(sizeof(count)))
+	{
+		return false;
+	}
+	memcpy(&count, blob.constData(), sizeof(count));
+	int header = sizeof(count) + count * (sizeof(quint32) + sizeof(quint8));
+	if (blob.size() < header)
+	{
+		return false;
+	}
+	const char *data = blob.constData() + sizeof(count);
+	ends.resize(count);
+	memcpy(ends.data(), data, count * sizeof(quint32));
+	levels.resize(count);
+	memcpy(levels.data(), data + count * sizeof(quint32), count * sizeof(quint8));
+	text = blob.mid(header);
+	return count == 0 || ends.last() <= quint32(text.size());
+}
+}
+
+LogMatcher::LogMatcher(const QString &what) : m_what(what)
+{
+	for (auto c : what)
+	{
+		if (c.unicode() >= 0x80)
+		{
+			m_isAscii = false;
+			return;
+		}
+	}
+	m_ascii = what.toLatin1();
+}
+
+bool LogMatcher::matches(const char *text, int length) const
+{
+	if (!m_isAscii)
+	{
+		return QString::fromUtf8(text, length).contains(m_what, Qt::CaseInsensitive);
+	}
+	// bytes of multi-byte UTF-8 sequences stay above 0x7f when lowered, so they can't match ASCII
+	int size = m_ascii.size();
+	const char *needle = m_ascii.constData();
+	for (int i = 0; i + size <= length; i++)
+	{
+		if (qstrnicmp(text + i, needle, size) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+LogStore::LogStore()
+{
+}
+
+LogStore::~LogStore()
+{
+}
+
+bool LogStore::open()
+{
+	m_file.reset(new QTemporaryFile(QDir::temp().absoluteFilePath("MultiMC-log.XXXXXX")));
+	if (!m_file->open())
+	{
+		qWarning() << "Could not create a file for the game log:" << m_file->errorString();
+		m_file.reset();
+		return false;
+	}
+	return true;
+}
+
+void LogStore::append(MessageLevel::Enum level, const char *text, int length)
+{
+	m_open.text.append(text, length);
+	m_open.ends.append(m_open.text.size());
+	m_open.levels.append(level);
+	if (m_open.levels.size() >= segmentLines || m_open.text.size() >= segmentText)
+	{
+		seal();
+	}
+}
+
+void LogStore::seal()
+{
+	Segment segment;
+	segment.offset = m_fileSize;
+	segment.firstLine = m_sealedLines;
+	segment.lines = m_open.levels.size();
+	auto compressed = qCompress(pack(m_open.ends, m_open.levels, m_open.text), 1);
+	segment.size = compressed.size();
+	if (m_file && m_file->seek(m_fileSize) && m_file->write(compressed) == compressed.size())
+	{
+		m_fileSize += compressed.size();
+	}
+	else
+	{
+		qWarning() << "Could not write the game log to disk, keeping it in memory.";
+		segment.data = compressed;
+	}
+	m_segments.append(segment);
+	m_sealedLines += segment.lines;
+	m_open = Lines();
+}
+
+void LogStore::clear()
+{
+	m_segments.clear();
+	m_sealedLines = 0;
+	m_open = Lines();
+	m_cache.clear();
+	if (m_file)
+	{
+		m_file->resize(0);
+	}
+	m_fileSize = 0;
+}
+
+const LogStore::Lines &LogStore::linesOf(int line, int &first) const
+{
+	if (line >= m_sealedLines)
+	{
+		first = m_sealedLines;
+		return m_open;
+	}
+	auto segment = std::upper_bound(m_segments.begin(), m_segments.end(), line,
+		[](int line, const Segment &segment)
+		{
+			return line < segment.firstLine;
+		}) - 1;
+	int index = segment - m_segments.begin();
+	first = segment->firstLine;
+	for (int i = 0; i < m_cache.size(); i++)
+	{
+		if (m_cache[i].first == index)
+		{
+			if (i != 0)
+			{
+				m_cache.move(i, 0);
+			}
+			return m_cache.first().second;
+		}
+	}
+
+	QByteArray compressed = segment->data;
+	if (compressed.isEmpty() && m_file->seek(segment->offset))
+	{
+		compressed = m_file->read(segment->size);
+	}
+	Lines lines;
+	if (!unpack(qUncompress(compressed), lines.ends, lines.levels, lines.text) || lines.ends.size() != segment->lines)
+	{
+		qWarning() << "Lost part of the game log, could not read it back from disk.";
+		lines.text.clear();
+		lines.ends.fill(0, segment->lines);
+		lines.levels.fill(MessageLevel::Unknown, segment->lines);
+	}
+	if (m_cache.size() == cachedSegments)
+	{
+		m_cache.removeLast();
+	}
+	m_cache.prepend(qMakePair(index, lines));
+	return m_cache.first().second;
+}
+
+MessageLevel::Enum LogStore::level(int line) const
+{
+	int first;
+	auto &lines = linesOf(line, first);
+	return MessageLevel::Enum(lines.levels[line - first]);
+}
+
+QByteArray LogStore::text(int line) const
+{
+	int first;
+	auto &lines = linesOf(line, first);
+	int index = line - first;
+	int start = index ? lines.ends[index - 1] : 0;
+	return lines.text.mid(start, lines.ends[index] - start);
+}
+
+int LogStore::find(const LogMatcher &matcher, int begin, int end, bool reverse) const
+{
+	begin = qMax(begin, 0);
+	end = qMin(end, size());
+	int line = reverse ? end - 1 : begin;
+	// a segment at a time, the lines are matched where they are in the decompressed text
+	while (reverse ? line >= begin : line < end)
+	{
+		int first;
+		auto &lines = linesOf(line, first);
+		int low = qMax(first, begin);
+		int high = qMin(first + lines.ends.size(), end);
+		for (int i = reverse ? high - 1 : low; reverse ? i >= low : i < high; reverse ? i-- : i++)
+		{
+			int index = i - first;
+			int start = index ? lines.ends[index - 1] : 0;
+			if (matcher.matches(lines.text.constData() + start, lines.ends[index] - start))
+			{
+				return i;
+			}
+		}
+		line = reverse ? low - 1 : high;
+	}
+	return -1;
+}
@@ -0,0 +1,106 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <memory>
+#include "MessageLevel.h"
+
+#include "multimc_logic_export.h"
+
+class QTemporaryFile;
+
+/*
+ * Case insensitive search for a piece of text in UTF-8 log lines.
+ * When the text is plain ASCII, the lines are searched as they are, without decoding them.
+ */
+class MULTIMC_LOGIC_EXPORT LogMatcher
+{
+public:
+	explicit LogMatcher(const QString &what);
+	bool matches(const char *text, int length) const;
+
+private:
+	QString m_what;
+	QByteArray m_ascii;
+	bool m_isAscii = true;
+};
+
+/*
+ * Append-only storage for log lines that don't need to be in memory.
+ *
+ * Lines are collected into segments. A full segment is compressed and written to a temporary
+ * file, leaving only its position behind. Reading a line decompresses its segment, and the
+ * last few segments read are kept around, so walking through the lines in order is cheap.
+ */
+class MULTIMC_LOGIC_EXPORT LogStore
+{
+public:
+	LogStore();
+	~LogStore();
+
+	/// Create the backing file. Without it, the store can't be used.
+	bool open();
+
+	void append(MessageLevel::Enum level, const char *text, int length);
+	void clear();
+
+	int size() const
+	{
+		return m_sealedLines + m_open.levels.size();
+	}
+	MessageLevel::Enum level(int line) const;
+	/// The line as UTF-8
+	QByteArray text(int line) const;
+	/// The first line in [begin, end) the matcher matches, or the last one when searching in reverse. -1 if there is none.
+	int find(const LogMatcher &matcher, int begin, int end, bool reverse) const;
+
+private: /* types */
+	struct Lines
+	{
+		QByteArray text;
+		// end of each line in text
+		QVector<quint32> ends;
+		QVector<quint8> levels;
+	};
+	struct Segment
+	{
+		qint64 offset;
+		int size;
+		int firstLine;
+		int lines;
+		// the compressed lines, only when they could not be written to the file
+		QByteArray data;
+	};
+
+private: /* methods */
+	void seal();
+	const Lines &linesOf(int line, int &first) const;
+
+private: /* data */
+	std::unique_ptr<QTemporaryFile> m_file;
+	qint64 m_fileSize = 0;
+	QVector<Segment> m_segments;
+	int m_sealedLines = 0;
+	// the segment being filled
+	Lines m_open;
+	// decompressed segments, most recently used first
+	mutable QList<QPair<int, Lines>> m_cache;
+};
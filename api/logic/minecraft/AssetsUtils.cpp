@@ -17,14 +17,13 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QCryptographicHash>
-#include <QJsonParseError>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QVariant>
 #include <QDebug>
+#include <QSet>
+#include <QtConcurrentMap>
 
 #include "AssetsUtils.h"
 #include "FileSystem.h"
+#include "ContentStore.h"
 #include "net/Download.h"
 #include "net/ChecksumValidator.h"
 
@@ -32,6 +31,483 @@
 namespace AssetsUtils
 {
 
+namespace
+{
+/*
+ * A minimal pull parser for assets indexes.
+ *
+ * It walks the raw bytes of the file once, writing the object paths straight into the index
+ * path pool and the hashes as binary. Anything the index doesn't need is skipped unparsed.
+ */
+class IndexReader
+{
+public:
+	IndexReader(const char *data, qint64 size) : m_pos(data), m_begin(data), m_end(data + size)
+	{
+	}
+
+	bool read(AssetsIndex *index)
+	{
+		if (!expect('{'))
+		{
+			return false;
+		}
+		if (consume('}'))
+		{
+			return atEnd();
+		}
+		do
+		{
+			if (!readKey(m_key))
+			{
+				return false;
+			}
+			if (m_key == "objects")
+			{
+				if (!readObjects(index))
+				{
+					return false;
+				}
+			}
+			else if (m_key == "virtual")
+			{
+				if (!readBool(index->isVirtual))
+				{
+					return false;
+				}
+			}
+			else if (!skipValue(0))
+			{
+				return false;
+			}
+		} while (consume(','));
+		return expect('}') && atEnd();
+	}
+
+	QString error() const
+	{
+		return m_error;
+	}
+
+private:
+	bool readObjects(AssetsIndex *index)
+	{
+		if (!expect('{'))
+		{
+			return false;
+		}
+		if (consume('}'))
+		{
+			return true;
+		}
+		do
+		{
+			AssetsIndex::Entry entry;
+			entry.pathOffset = index->pathPool.size();
+			if (!readString(index->pathPool) || !expect(':'))
+			{
+				return false;
+			}
+			entry.pathLength = index->pathPool.size() - entry.pathOffset;
+			if (!readObject(entry))
+			{
+				return false;
+			}
+			index->entries.append(entry);
+		} while (consume(','));
+		return expect('}');
+	}
+
+	bool readObject(AssetsIndex::Entry &entry)
+	{
+		bool hasHash = false;
+		entry.size = 0;
+		if (!expect('{'))
+		{
+			return false;
+		}
+		if (!consume('}'))
+		{
+			do
+			{
+				if (!readKey(m_key))
+				{
+					return false;
+				}
+				if (m_key == "hash")
+				{
+					m_value.clear();
+					if (!readString(m_value))
+					{
+						return false;
+					}
+					if (m_value.size() != 40 || !fromHex(m_value, entry.hash))
+					{
+						return fail("Invalid object hash");
+					}
+					hasHash = true;
+				}
+				else if (m_key == "size")
+				{
+					if (!readSize(entry.size))
+					{
+						return false;
+					}
+				}
+				else if (!skipValue(0))
+				{
+					return false;
+				}
+			} while (consume(','));
+			if (!expect('}'))
+			{
+				return false;
+			}
+		}
+		if (!hasHash)
+		{
+			return fail("Object without a hash");
+		}
+		return true;
+	}
+
+	static int hexValue(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		return -1;
+	}
+
+	static bool fromHex(const QByteArray &hex, quint8 *out)
+	{
+		for (int i = 0; i < hex.size() / 2; i++)
+		{
+			int high = hexValue(hex[2 * i]);
+			int low = hexValue(hex[2 * i + 1]);
+			if (high < 0 || low < 0)
+			{
+				return false;
+			}
+			out[i] = quint8((high << 4) | low);
+		}
+		return true;
+	}
+
+	bool readKey(QByteArray &key)
+	{
+		key.clear();
+		return readString(key) && expect(':');
+	}
+
+	// appends the UTF-8 contents of the string to out
+	bool readString(QByteArray &out)
+	{
+		if (!expect('"'))
+		{
+			return false;
+		}
+		while (true)
+		{
+			// copy runs of plain characters in one go
+			const char *start = m_pos;
+			while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\')
+			{
+				m_pos++;
+			}
+			out.append(start, m_pos - start);
+			if (m_pos >= m_end)
+			{
+				return fail("Unterminated string");
+			}
+			if (*m_pos++ == '"')
+			{
+				return true;
+			}
+			if (m_pos >= m_end)
+			{
+				return fail("Unterminated string");
+			}
+			char escaped = *m_pos++;
+			switch (escaped)
+			{
+				case '"':
+				case '\\':
+				case '/':
+					out.append(escaped);
+					break;
+				case 'b':
+					out.append('\b');
+					break;
+				case 'f':
+					out.append('\f');
+					break;
+				case 'n':
+					out.append('\n');
+					break;
+				case 'r':
+					out.append('\r');
+					break;
+				case 't':
+					out.append('\t');
+					break;
+				case 'u':
+				{
+					uint codepoint;
+					if (!readCodeUnit(codepoint))
+					{
+						return false;
+					}
+					if (codepoint >= 0xD800 && codepoint < 0xDC00)
+					{
+						uint low;
+						if (m_end - m_pos < 2 || m_pos[0] != '\\' || m_pos[1] != 'u')
+						{
+							return fail("Unpaired surrogate");
+						}
+						m_pos += 2;
+						if (!readCodeUnit(low) || low < 0xDC00 || low >= 0xE000)
+						{
+							return fail("Unpaired surrogate");
+						}
+						codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					appendUtf8(out, codepoint);
+					break;
+				}
+				default:
+					return fail("Invalid escape sequence");
+			}
+		}
+	}
+
+	bool readCodeUnit(uint &out)
+	{
+		if (m_end - m_pos < 4)
+		{
+			return fail("Invalid escape sequence");
+		}
+		out = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			int digit = hexValue(*m_pos++);
+			if (digit < 0)
+			{
+				return fail("Invalid escape sequence");
+			}
+			out = (out << 4) | digit;
+		}
+		return true;
+	}
+
+	static void appendUtf8(QByteArray &out, uint codepoint)
+	{
+		if (codepoint < 0x80)
+		{
+			out.append(char(codepoint));
+		}
+		else if (codepoint < 0x800)
+		{
+			out.append(char(0xC0 | (codepoint >> 6)));
+			out.append(char(0x80 | (codepoint & 0x3F)));
+		}
+		else if (codepoint < 0x10000)
+		{
+			out.append(char(0xE0 | (codepoint >> 12)));
+			out.append(char(0x80 | ((codepoint >> 6) & 0x3F)));
+			out.append(char(0x80 | (codepoint & 0x3F)));
+		}
+		else
+		{
+			out.append(char(0xF0 | (codepoint >> 18)));
+			out.append(char(0x80 | ((codepoint >> 12) & 0x3F)));
+			out.append(char(0x80 | ((codepoint >> 6) & 0x3F)));
+			out.append(char(0x80 | (codepoint & 0x3F)));
+		}
+	}
+
+	// sizes are integers, but take anything JSON calls a number
+	bool readSize(qint64 &out)
+	{
+		skipWhitespace();
+		const char *start = m_pos;
+		if (!skipNumber())
+		{
+			return false;
+		}
+		// the usual case, a plain integer
+		qint64 value = 0;
+		const char *digit = start;
+		while (digit < m_pos && *digit >= '0' && *digit <= '9' && value < (Q_INT64_C(1) << 58))
+		{
+			value = value * 10 + (*digit++ - '0');
+		}
+		if (digit == m_pos && digit != start)
+		{
+			out = value;
+			return true;
+		}
+		bool ok = false;
+		out = QByteArray::fromRawData(start, m_pos - start).toDouble(&ok);
+		return ok || fail("Invalid number");
+	}
+
+	bool readBool(bool &out)
+	{
+		skipWhitespace();
+		if (literal("true"))
+		{
+			out = true;
+			return true;
+		}
+		if (literal("false"))
+		{
+			out = false;
+			return true;
+		}
+		return fail("Expected a boolean");
+	}
+
+	bool skipValue(int depth)
+	{
+		// nothing legitimate nests this deep
+		if (depth > 1024)
+		{
+			return fail("Too deeply nested");
+		}
+		skipWhitespace();
+		if (m_pos >= m_end)
+		{
+			return fail("Unexpected end of file");
+		}
+		switch (*m_pos)
+		{
+			case '"':
+				m_value.clear();
+				return readString(m_value);
+			case '{':
+				m_pos++;
+				if (consume('}'))
+				{
+					return true;
+				}
+				do
+				{
+					if (!readKey(m_value) || !skipValue(depth + 1))
+					{
+						return false;
+					}
+				} while (consume(','));
+				return expect('}');
+			case '[':
+				m_pos++;
+				if (consume(']'))
+				{
+					return true;
+				}
+				do
+				{
+					if (!skipValue(depth + 1))
+					{
+						return false;
+					}
+				} while (consume(','));
+				return expect(']');
+			case 't':
+			case 'f':
+			case 'n':
+				if (literal("true") || literal("false") || literal("null"))
+				{
+					return true;
+				}
+				return fail("Unexpected token");
+			default:
+				return skipNumber();
+		}
+	}
+
+	bool skipNumber()
+	{
+		const char *start = m_pos;
+		if (m_pos < m_end && *m_pos == '-')
+		{
+			m_pos++;
+		}
+		while (m_pos < m_end && ((*m_pos >= '0' && *m_pos <= '9') || *m_pos == '.' || *m_pos == 'e' ||
+								  *m_pos == 'E' || *m_pos == '+' || *m_pos == '-'))
+		{
+			m_pos++;
+		}
+		if (m_pos == start)
+		{
+			return fail("Unexpected token");
+		}
+		return true;
+	}
+
+	bool literal(const char *text)
+	{
+		auto length = qstrlen(text);
+		if (qint64(length) <= m_end - m_pos && !memcmp(m_pos, text, length))
+		{
+			m_pos += length;
+			return true;
+		}
+		return false;
+	}
+
+	void skipWhitespace()
+	{
+		while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+		{
+			m_pos++;
+		}
+	}
+
+	bool consume(char c)
+	{
+		skipWhitespace();
+		if (m_pos < m_end && *m_pos == c)
+		{
+			m_pos++;
+			return true;
+		}
+		return false;
+	}
+
+	bool expect(char c)
+	{
+		return consume(c) || fail(QString("Expected '%1'").arg(c));
+	}
+
+	bool atEnd()
+	{
+		skipWhitespace();
+		return m_pos == m_end || fail("Garbage after the end of the index");
+	}
+
+	bool fail(const QString &error)
+	{
+		if (m_error.isEmpty())
+		{
+			m_error = QString("%1 at offset %2").arg(error).arg(m_pos - m_begin);
+		}
+		return false;
+	}
+
+	const char *m_pos;
+	const char *m_begin;
+	const char *m_end;
+	QString m_error;
+	// scratch buffers, reused for every key and skipped value
+	QByteArray m_key;
+	QByteArray m_value;
+};
+}
+
 /*
  * Returns true on success, with index populated
  * index is undefined otherwise
@@ -61,128 +537,324 @@ bool loadAssetsIndexJson(QString assetsId, QString path, AssetsIndex *index)
 		return false;
 	}
 	index->id = assetsId;
-
-	// Read the file and close it.
-	QByteArray jsonData = file.readAll();
-	file.close();
-
-	QJsonParseError parseError;
-	QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
-
-	// Fail if the JSON is invalid.
-	if (parseError.error != QJsonParseError::NoError)
+	index->isVirtual = false;
+	index->entries.clear();
+	index->pathPool.clear();
+
+	// Map the file if we can, read it if we can't.
+	QByteArray buffer;
+	const char *data = nullptr;
+	qint64 size = file.size();
+	if (size > 0)
 	{
-		qCritical() << "Failed to parse assets index file:" << parseError.errorString()
-					 << "at offset " << QString::number(parseError.offset);
-		return false;
+		data = reinterpret_cast<const char *>(file.map(0, size));
+	}
+	if (!data)
+	{
+		buffer = file.readAll();
+		data = buffer.constData();
+		size = buffer.size();
 	}
 
-	// Make sure the root is an object.
-	if (!jsonDoc.isObject())
+	// Paths average a bit over 30 bytes, objects take about 100 bytes of JSON
+	index->entries.reserve(size / 100);
+	index->pathPool.reserve(size / 3);
+
+	IndexReader reader(data, size);
+	if (!reader.read(index))
 	{
-		qCritical() << "Invalid assets index JSON: Root should be an array.";
+		qCritical() << "Failed to parse assets index file:" << reader.error();
 		return false;
 	}
+	index->pathPool.squeeze();
+	index->entries.squeeze();
+	return true;
+}
 
-	QJsonObject root = jsonDoc.object();
+/*
+ * The manifest of a virtual assets folder lives next to it, as <assets id>.manifest
+ *
+ * First line: "MMC-ASSETS-MANIFEST 1 <signature>"
+ *   signature is the size and timestamp of the index the folder was built from, or '-'
+ *   if the build wasn't complete (some objects were missing or failed).
+ * Then one "<hash> <path>" line per file put into the folder.
+ */
+static const QByteArray manifestMagic = "MMC-ASSETS-MANIFEST 1 ";
+
+struct Manifest
+{
+	QByteArray signature;
+	QMap<QString, QString> files;
+};
 
-	QJsonValue isVirtual = root.value("virtual");
-	if (!isVirtual.isUndefined())
+static QByteArray indexSignature(const QString &indexPath)
+{
+	QFileInfo info(indexPath);
+	return QByteArray::number(info.size()) + ':' + QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+static Manifest readManifest(const QString &path, bool signatureOnly)
+{
+	Manifest out;
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
 	{
-		index->isVirtual = isVirtual.toBool(false);
+		return out;
 	}
+	auto header = file.readLine().trimmed();
+	if (!header.startsWith(manifestMagic))
+	{
+		return out;
+	}
+	out.signature = header.mid(manifestMagic.size());
+	if (signatureOnly)
+	{
+		return out;
+	}
+	for (auto line : file.readAll().split('\n'))
+	{
+		int space = line.indexOf(' ');
+		if (space <= 0)
+		{
+			continue;
+		}
+		out.files.insert(QString::fromUtf8(line.mid(space + 1)), QString::fromLatin1(line.left(space)));
+	}
+	return out;
+}
 
-	QJsonValue objects = root.value("objects");
-	QVariantMap map = objects.toVariant().toMap();
-
-	for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter)
+static void writeManifest(const QString &path, const Manifest &manifest)
+{
+	QByteArray data = manifestMagic + (manifest.signature.isEmpty() ? QByteArray("-") : manifest.signature) + '\n';
+	for (auto iter = manifest.files.begin(); iter != manifest.files.end(); iter++)
 	{
-		// qDebug() << iter.key();
+		data += iter.value().toLatin1() + ' ' + iter.key().toUtf8() + '\n';
+	}
+	try
+	{
+		FS::write(path, data);
+	}
+	catch (Exception & e)
+	{
+		qWarning() << "Couldn't write virtual assets manifest:" << e.what();
+	}
+}
 
-		QVariant variant = iter.value();
-		QVariantMap nested_objects = variant.toMap();
+struct AssetsPaths
+{
+	explicit AssetsPaths(const QString &assetsId)
+	{
+		QDir assetsDir = QDir("assets/");
+		objectDir = QDir(FS::PathCombine(assetsDir.path(), "objects"));
+		QDir virtualDir = QDir(FS::PathCombine(assetsDir.path(), "virtual"));
+		indexPath = FS::PathCombine(assetsDir.path(), "indexes", assetsId + ".json");
+		virtualRoot = QDir(FS::PathCombine(virtualDir.path(), assetsId));
+		manifestPath = FS::PathCombine(virtualDir.path(), assetsId + ".manifest");
+	}
+	QDir objectDir;
+	QString indexPath;
+	QDir virtualRoot;
+	QString manifestPath;
+};
 
-		AssetObject object;
+QDir getAssetsDir(QString assetsId)
+{
+	return AssetsPaths(assetsId).virtualRoot;
+}
 
-		for (QVariantMap::const_iterator nested_iter = nested_objects.begin();
-			 nested_iter != nested_objects.end(); ++nested_iter)
+/*
+ * The manifest lives outside of the folder it describes, so the folder can be deleted or pruned behind its back.
+ * Check that it's there, along with a few of the files spread over the manifest.
+ */
+static bool folderIntact(const AssetsPaths &paths, const Manifest &manifest)
+{
+	if (manifest.files.isEmpty())
+	{
+		// nothing was put in the folder
+		return true;
+	}
+	if (!paths.virtualRoot.exists())
+	{
+		return false;
+	}
+	const int samples = 16;
+	int step = qMax(1, manifest.files.size() / samples);
+	int i = 0;
+	for (auto iter = manifest.files.begin(); iter != manifest.files.end(); iter++, i++)
+	{
+		if (i % step == 0 && !QFileInfo::exists(FS::PathCombine(paths.virtualRoot.path(), iter.key())))
 		{
-			// qDebug() << nested_iter.key() << nested_iter.value().toString();
-			QString key = nested_iter.key();
-			QVariant value = nested_iter.value();
-
-			if (key == "hash")
-			{
-				object.hash = value.toString();
-			}
-			else if (key == "size")
-			{
-				object.size = value.toDouble();
-			}
+			return false;
 		}
-
-		index->objects.insert(iter.key(), object);
 	}
+	return QFileInfo::exists(FS::PathCombine(paths.virtualRoot.path(), manifest.files.lastKey()));
+}
 
-	return true;
+bool isReconstructed(QString assetsId)
+{
+	AssetsPaths paths(assetsId);
+	auto manifest = readManifest(paths.manifestPath, false);
+	return manifest.signature == indexSignature(paths.indexPath) && folderIntact(paths, manifest);
 }
 
-QDir reconstructAssets(QString assetsId)
+void invalidateObjects(QString assetsId, const QStringList &hashes)
 {
-	QDir assetsDir = QDir("assets/");
-	QDir indexDir = QDir(FS::PathCombine(assetsDir.path(), "indexes"));
-	QDir objectDir = QDir(FS::PathCombine(assetsDir.path(), "objects"));
-	QDir virtualDir = QDir(FS::PathCombine(assetsDir.path(), "virtual"));
+	AssetsPaths paths(assetsId);
+	if (!QFileInfo::exists(paths.manifestPath))
+	{
+		return;
+	}
+	auto manifest = readManifest(paths.manifestPath, false);
+	auto toRemove = hashes.toSet();
+	for (auto iter = manifest.files.begin(); iter != manifest.files.end();)
+	{
+		if (toRemove.contains(iter.value()))
+		{
+			// the folder may share the object file, so it's just as bad
+			QFile::remove(FS::PathCombine(paths.virtualRoot.path(), iter.key()));
+			iter = manifest.files.erase(iter);
+		}
+		else
+		{
+			iter++;
+		}
+	}
+	manifest.signature.clear();
+	writeManifest(paths.manifestPath, manifest);
+}
 
-	QString indexPath = FS::PathCombine(indexDir.path(), assetsId + ".json");
-	QFile indexFile(indexPath);
-	QDir virtualRoot(FS::PathCombine(virtualDir.path(), assetsId));
+QDir reconstructAssets(QString assetsId, ProgressCallback progress, const QAtomicInt *cancel)
+{
+	AssetsPaths paths(assetsId);
+	QDir &virtualRoot = paths.virtualRoot;
 
-	if (!indexFile.exists())
+	if (!QFileInfo(paths.indexPath).exists())
 	{
-		qCritical() << "No assets index file" << indexPath << "; can't reconstruct assets";
+		qCritical() << "No assets index file" << paths.indexPath << "; can't reconstruct assets";
 		return virtualRoot;
 	}
 
-	qDebug() << "reconstructAssets" << assetsDir.path() << indexDir.path()
-				 << objectDir.path() << virtualDir.path() << virtualRoot.path();
+	// nothing changed since the last complete build. Not even worth looking at the objects.
+	auto signature = indexSignature(paths.indexPath);
+	auto previous = readManifest(paths.manifestPath, false);
+	if (previous.signature == signature && folderIntact(paths, previous))
+	{
+		return virtualRoot;
+	}
 
 	AssetsIndex index;
-	bool loadAssetsIndex = AssetsUtils::loadAssetsIndexJson(assetsId, indexPath, &index);
+	if (!AssetsUtils::loadAssetsIndexJson(assetsId, paths.indexPath, &index))
+	{
+		return virtualRoot;
+	}
 
-	if (loadAssetsIndex && index.isVirtual)
+	Manifest current;
+	if (!index.isVirtual)
 	{
-		qDebug() << "Reconstructing virtual assets folder at" << virtualRoot.path();
+		// nothing to build. Remember that, so we don't have to load the index next time.
+		current.signature = signature;
+		writeManifest(paths.manifestPath, current);
+		return virtualRoot;
+	}
+
+	qDebug() << "Reconstructing virtual assets folder at" << virtualRoot.path();
 
-		for (QString map : index.objects.keys())
+	struct Work
+	{
+		QString path;
+		QString hash;
+		bool known = false;
+		FS::CloneMethod result = FS::CloneMethod::Failed;
+		bool ok = false;
+	};
+	QVector<Work> work;
+	work.reserve(index.size());
+	for (int i = 0; i < index.size(); i++)
+	{
+		Work item;
+		item.path = index.path(i);
+		item.hash = index.hash(i);
+		item.known = previous.files.value(item.path) == item.hash;
+		work.append(item);
+	}
+
+	ContentStore store(paths.objectDir.path());
+	QAtomicInt done;
+	const int total = work.size();
+	auto materialise = [&](Work &item)
+	{
+		// left out, so the build counts as incomplete
+		if (cancel && cancel->loadAcquire())
+		{
+			return;
+		}
+		QString target_path = FS::PathCombine(virtualRoot.path(), item.path);
+		// put there by an earlier build, or already linked to the object
+		if ((item.known && QFileInfo::exists(target_path)) || store.isLinked(item.hash, target_path))
+		{
+			item.ok = true;
+		}
+		else if (store.contains(item.hash))
 		{
-			AssetObject asset_object = index.objects.value(map);
-			QString target_path = FS::PathCombine(virtualRoot.path(), map);
-			QFile target(target_path);
+			// the game only reads these files, so they can share the objects
+			item.result = store.materialise(item.hash, target_path);
+			item.ok = item.result != FS::CloneMethod::Failed;
+		}
+		int count = done.fetchAndAddOrdered(1) + 1;
+		if (progress && (count % 64 == 0 || count == total))
+		{
+			progress(count, total);
+		}
+	};
+	QtConcurrent::blockingMap(work, materialise);
 
-			QString tlk = asset_object.hash.left(2);
+	int linked = 0, cloned = 0, copied = 0, missing = 0;
+	for (const auto &item : work)
+	{
+		if (!item.ok)
+		{
+			missing++;
+			continue;
+		}
+		current.files.insert(item.path, item.hash);
+		switch (item.result)
+		{
+			case FS::CloneMethod::Hardlink:
+				linked++;
+				break;
+			case FS::CloneMethod::Reflink:
+				cloned++;
+				break;
+			case FS::CloneMethod::Copy:
+				copied++;
+				break;
+			case FS::CloneMethod::Failed:
+				break;
+		}
+	}
 
-			QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-			QFile original(original_path);
-			if (!original.exists())
-				continue;
-			if (!target.exists())
-			{
-				QFileInfo info(target_path);
-				QDir target_dir = info.dir();
-				// qDebug() << target_dir;
-				if (!target_dir.exists())
-					QDir("").mkpath(target_dir.path());
-
-				bool couldCopy = original.copy(target_path);
-				qDebug() << " Copying" << original_path << "to" << target_path
-							 << QString::number(couldCopy); // << original.errorString();
-			}
+	// remove whatever the index no longer has
+	int removed = 0;
+	for (auto iter = previous.files.begin(); iter != previous.files.end(); iter++)
+	{
+		if (!current.files.contains(iter.key()))
+		{
+			QFile::remove(FS::PathCombine(virtualRoot.path(), iter.key()));
+			removed++;
 		}
+	}
+
+	qDebug() << "Virtual assets updated:" << linked << "linked," << cloned << "cloned," << copied << "copied,"
+			 << removed << "removed," << missing << "missing";
 
-		// TODO: Write last used time to virtualRoot/.lastused
+	// only a complete build can be skipped next time
+	if (!missing)
+	{
+		current.signature = signature;
 	}
+	writeManifest(paths.manifestPath, current);
 
+	// TODO: Write last used time to virtualRoot/.lastused
 	return virtualRoot;
 }
 
@@ -220,12 +892,32 @@ QString AssetObject::getRelPath()
 	return hash.left(2) + "/" + hash;
 }
 
+QString AssetsIndex::path(int i) const
+{
+	const auto &entry = entries[i];
+	return QString::fromUtf8(pathPool.constData() + entry.pathOffset, entry.pathLength);
+}
+
+QString AssetsIndex::hash(int i) const
+{
+	auto raw = QByteArray::fromRawData(reinterpret_cast<const char *>(entries[i].hash), sizeof(entries[i].hash));
+	return QString::fromLatin1(raw.toHex());
+}
+
+AssetObject AssetsIndex::object(int i) const
+{
+	AssetObject object;
+	object.hash = hash(i);
+	object.size = entries[i].size;
+	return object;
+}
+
 NetJobPtr AssetsIndex::getDownloadJob()
 {
 	auto job = new NetJob(QObject::tr("Assets for %1").arg(id));
-	for (auto &object : objects.values())
+	for (int i = 0; i < size(); i++)
 	{
-		auto dl = object.getDownloadAction();
+		auto dl = object(i).getDownloadAction();
 		if(dl)
 		{
 			job->addNetAction(dl);
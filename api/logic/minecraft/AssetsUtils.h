@@ -17,10 +17,16 @@
 
 #include <QString>
 #include <QMap>
+#include <QVector>
+#include <QDir>
+#include <QAtomicInt>
+#include <functional>
 #include "net/NetAction.h"
 #include "net/NetJob.h"
 
-struct AssetObject
+#include "multimc_logic_export.h"
+
+struct MULTIMC_LOGIC_EXPORT AssetObject
 {
 	QString getRelPath();
 	QUrl getUrl();
@@ -31,18 +37,62 @@ struct AssetObject
 	qint64 size;
 };
 
-struct AssetsIndex
+/**
+ * A loaded assets index, kept compact: modern indexes have thousands of objects.
+ *
+ * Objects are kept in index order, with binary hashes and their paths in one shared UTF-8 pool.
+ */
+struct MULTIMC_LOGIC_EXPORT AssetsIndex
 {
+	struct Entry
+	{
+		/// binary SHA-1 of the object
+		quint8 hash[20];
+		qint64 size;
+		/// the path of the object in the game, in pathPool
+		quint32 pathOffset;
+		quint32 pathLength;
+	};
+
 	NetJobPtr getDownloadJob();
 
+	int size() const
+	{
+		return entries.size();
+	}
+	QString path(int i) const;
+	/// hex SHA-1 of the object
+	QString hash(int i) const;
+	AssetObject object(int i) const;
+
 	QString id;
-	QMap<QString, AssetObject> objects;
+	QVector<Entry> entries;
+	QByteArray pathPool;
 	bool isVirtual = false;
 };
 
 namespace AssetsUtils
 {
-bool loadAssetsIndexJson(QString id, QString file, AssetsIndex* index);
-/// Reconstruct a virtual assets folder for the given assets ID and return the folder
-QDir reconstructAssets(QString assetsId);
+/// Progress of a long operation as (done, total). Can be called from any thread.
+typedef std::function<void(int, int)> ProgressCallback;
+
+MULTIMC_LOGIC_EXPORT bool loadAssetsIndexJson(QString id, QString file, AssetsIndex* index);
+
+/// Get the virtual assets folder for the given assets ID, without building it
+QDir getAssetsDir(QString assetsId);
+
+/// Make the next reconstruction of the given assets ID put the given objects (hex SHA-1) in again
+void invalidateObjects(QString assetsId, const QStringList &hashes);
+
+/// Is the virtual assets folder for the given assets ID up to date with its index?
+bool isReconstructed(QString assetsId);
+
+/**
+ * Reconstruct a virtual assets folder for the given assets ID and return the folder
+ *
+ * A manifest of what was put in the folder is kept next to it. If the index didn't change
+ * since the last complete build, nothing is done at all. Otherwise, only the changes are applied,
+ * spread over the global thread pool. Setting the cancel flag stops it, leaving an incomplete build.
+ */
+QDir reconstructAssets(QString assetsId, ProgressCallback progress = ProgressCallback(), const QAtomicInt *cancel = nullptr);
 }
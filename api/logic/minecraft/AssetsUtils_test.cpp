@@ -0,0 +1,161 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCryptographicHash>
+#include "TestUtil.h"
+
+#include "minecraft/AssetsUtils.h"
+#include "FileSystem.h"
+
+class AssetsUtilsTest : public QObject
+{
+	Q_OBJECT
+private:
+	// what the index loader used to do, as the reference and the baseline for the benchmark
+	static bool loadWithQJson(QString path, QMap<QString, AssetObject> &objects, bool &isVirtual)
+	{
+		QFile file(path);
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			return false;
+		}
+		QJsonParseError parseError;
+		QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll(), &parseError);
+		if (parseError.error != QJsonParseError::NoError || !jsonDoc.isObject())
+		{
+			return false;
+		}
+		QJsonObject root = jsonDoc.object();
+		isVirtual = root.value("virtual").toBool(false);
+		QVariantMap map = root.value("objects").toVariant().toMap();
+		for (auto iter = map.begin(); iter != map.end(); ++iter)
+		{
+			QVariantMap nested = iter.value().toMap();
+			AssetObject object;
+			object.hash = nested.value("hash").toString();
+			object.size = nested.value("size").toDouble();
+			objects.insert(iter.key(), object);
+		}
+		return true;
+	}
+
+	// something shaped like a modern index
+	QString makeIndex(int count)
+	{
+		QJsonObject objects;
+		for (int i = 0; i < count; i++)
+		{
+			auto hash = QCryptographicHash::hash(QByteArray::number(i), QCryptographicHash::Sha1).toHex();
+			QJsonObject object;
+			object.insert("hash", QString::fromLatin1(hash));
+			object.insert("size", 1000 + i * 37);
+			objects.insert(QString("minecraft/sounds/mob/creature%1/step%2.ogg").arg(i / 10).arg(i % 10), object);
+		}
+		QJsonObject root;
+		root.insert("objects", objects);
+		root.insert("virtual", true);
+		auto path = FS::PathCombine(tempDir.path(), QString("index-%1.json").arg(count));
+		FS::write(path, QJsonDocument(root).toJson());
+		return path;
+	}
+
+	QString writeIndex(const QByteArray &data)
+	{
+		auto path = FS::PathCombine(tempDir.path(), "written.json");
+		FS::write(path, data);
+		return path;
+	}
+
+	QTemporaryDir tempDir;
+
+private
+slots:
+	void test_matchesQJson()
+	{
+		auto path = makeIndex(3500);
+
+		QMap<QString, AssetObject> expected;
+		bool expectedVirtual = false;
+		QVERIFY(loadWithQJson(path, expected, expectedVirtual));
+
+		AssetsIndex index;
+		QVERIFY(AssetsUtils::loadAssetsIndexJson("test", path, &index));
+		QCOMPARE(index.id, QString("test"));
+		QCOMPARE(index.isVirtual, expectedVirtual);
+		QCOMPARE(index.size(), expected.size());
+		for (int i = 0; i < index.size(); i++)
+		{
+			auto path = index.path(i);
+			QVERIFY(expected.contains(path));
+			QCOMPARE(index.hash(i), expected[path].hash);
+			QCOMPARE(index.entries[i].size, expected[path].size);
+		}
+	}
+
+	void test_escapes()
+	{
+		auto path = writeIndex(
+			"{\"objects\": {\"a\\/b \\\"c\\\" \\u00e9\\ud83d\\ude00.txt\": "
+			"{\"size\": 1.5e1, \"comment\": [1, {\"x\": null}], \"hash\": \"BDF48EF6B5D0D23BBB02E17D04865216179F510A\"}}, "
+			"\"map_to_resources\": true}");
+		AssetsIndex index;
+		QVERIFY(AssetsUtils::loadAssetsIndexJson("test", path, &index));
+		QCOMPARE(index.isVirtual, false);
+		QCOMPARE(index.size(), 1);
+		QCOMPARE(index.path(0), QString::fromUtf8("a/b \"c\" \xc3\xa9\xf0\x9f\x98\x80.txt"));
+		QCOMPARE(index.hash(0), QString("bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+		QCOMPARE(index.entries[0].size, qint64(15));
+	}
+
+	void test_invalid_data()
+	{
+		QTest::addColumn<QByteArray>("data");
+		QTest::newRow("empty") << QByteArray();
+		QTest::newRow("truncated") << QByteArray("{\"objects\": {\"a\": {\"hash\": \"bdf48ef6b5d0d23bbb02e17d04865216179f510a\"");
+		QTest::newRow("short hash") << QByteArray("{\"objects\": {\"a\": {\"hash\": \"bdf48e\", \"size\": 1}}}");
+		QTest::newRow("no hash") << QByteArray("{\"objects\": {\"a\": {\"size\": 1}}}");
+		QTest::newRow("bad escape") << QByteArray("{\"objects\": {\"\\q\": {}}}");
+		QTest::newRow("garbage") << QByteArray("{} {}");
+		QTest::newRow("array") << QByteArray("[]");
+	}
+	void test_invalid()
+	{
+		QFETCH(QByteArray, data);
+		AssetsIndex index;
+		QVERIFY(!AssetsUtils::loadAssetsIndexJson("test", writeIndex(data), &index));
+	}
+
+	void test_benchmark_data()
+	{
+		QTest::addColumn<bool>("streaming");
+		QTest::newRow("QJsonDocument") << false;
+		QTest::newRow("streaming") << true;
+	}
+	void test_benchmark()
+	{
+		QFETCH(bool, streaming);
+		auto path = makeIndex(3500);
+		if (streaming)
+		{
+			QBENCHMARK
+			{
+				AssetsIndex index;
+				AssetsUtils::loadAssetsIndexJson("test", path, &index);
+			}
+		}
+		else
+		{
+			QBENCHMARK
+			{
+				QMap<QString, AssetObject> objects;
+				bool isVirtual;
+				loadWithQJson(path, objects, isVirtual);
+			}
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(AssetsUtilsTest)
+
+#include "AssetsUtils_test.moc"
@@ -59,7 +59,7 @@ QList< std::shared_ptr< NetAction > > Library::getDownloads(OpSys system, class
 	bool local = isLocal();
 	bool isForge = (hint() == "forge-pack-xz");
 
-	auto add_download = [&](QString storage, QString url, QString sha1 = QString())
+	auto add_download = [&](QString storage, QString url, QString sha1 = QString(), qint64 size = 0)
 	{
 		auto entry = cache->resolveEntry("libraries", storage);
 		if(isAlwaysStale)
@@ -106,23 +106,25 @@ QList< std::shared_ptr< NetAction > > Library::getDownloads(OpSys system, class
 		{
 			qDebug() << "XzDownload for:" << rawName() << "storage:" << storage << "url:" << url;
 			out.append(ForgeXzDownload::make(storage, entry));
+			return true;
+		}
+		auto dl = Net::Download::makeCached(url, entry, options);
+		if(size > 0)
+		{
+			// the known size lets the NetJob schedule the download better
+			dl->m_total_progress = size;
+		}
+		if(sha1.size())
+		{
+			auto rawSha1 = QByteArray::fromHex(sha1.toLatin1());
+			dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
+			qDebug() << "Checksummed Download for:" << rawName() << "storage:" << storage << "url:" << url;
 		}
 		else
 		{
-			if(sha1.size())
-			{
-				auto rawSha1 = QByteArray::fromHex(sha1.toLatin1());
-				auto dl = Net::Download::makeCached(url, entry, options);
-				dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
-				qDebug() << "Checksummed Download for:" << rawName() << "storage:" << storage << "url:" << url;
-				out.append(dl);
-			}
-			else
-			{
-				out.append(Net::Download::makeCached(url, entry, options));
-				qDebug() << "Download for:" << rawName() << "storage:" << storage << "url:" << url;
-			}
+			qDebug() << "Download for:" << rawName() << "storage:" << storage << "url:" << url;
 		}
+		out.append(dl);
 		return true;
 	};
 
@@ -145,14 +147,14 @@ QList< std::shared_ptr< NetAction > > Library::getDownloads(OpSys system, class
 					{
 						auto cooked_storage = raw_storage;
 						cooked_storage.replace("${arch}", "32");
-						add_download(cooked_storage, nat32info->url, nat32info->sha1);
+						add_download(cooked_storage, nat32info->url, nat32info->sha1, nat32info->size);
 					}
 					auto nat64info = m_mojangDownloads->getDownloadInfo(nat64Classifier);
 					if(nat64info)
 					{
 						auto cooked_storage = raw_storage;
 						cooked_storage.replace("${arch}", "64");
-						add_download(cooked_storage, nat64info->url, nat64info->sha1);
+						add_download(cooked_storage, nat64info->url, nat64info->sha1, nat64info->size);
 					}
 				}
 				else
@@ -160,7 +162,7 @@ QList< std::shared_ptr< NetAction > > Library::getDownloads(OpSys system, class
 					auto info = m_mojangDownloads->getDownloadInfo(nativeClassifier);
 					if(info)
 					{
-						add_download(raw_storage, info->url, info->sha1);
+						add_download(raw_storage, info->url, info->sha1, info->size);
 					}
 				}
 			}
@@ -174,7 +176,7 @@ QList< std::shared_ptr< NetAction > > Library::getDownloads(OpSys system, class
 			if(m_mojangDownloads->artifact)
 			{
 				auto artifact = m_mojangDownloads->artifact;
-				add_download(raw_storage, artifact->url, artifact->sha1);
+				add_download(raw_storage, artifact->url, artifact->sha1, artifact->size);
 			}
 			else
 			{
@@ -221,6 +223,20 @@ QList< std::shared_ptr< NetAction > > Library::getDownloads(OpSys system, class
 	return out;
 }
 
+QStringList Library::getCachePaths(OpSys system) const
+{
+	QString raw_storage = storageSuffix(system);
+	if (raw_storage.contains("${arch}"))
+	{
+		auto nat32Storage = raw_storage;
+		nat32Storage.replace("${arch}", "32");
+		auto nat64Storage = raw_storage;
+		nat64Storage.replace("${arch}", "64");
+		return {nat32Storage, nat64Storage};
+	}
+	return {raw_storage};
+}
+
 bool Library::isActive() const
 {
 	bool result = true;
@@ -152,6 +152,9 @@ public: /* methods */
 	QList<NetActionPtr> getDownloads(OpSys system, class HttpMetaCache * cache,
 									 QStringList & failedFiles, const QString & overridePath) const;
 
+	// Get the paths in the 'libraries' cache base that getDownloads will look at
+	QStringList getCachePaths(OpSys system) const;
+
 private: /* methods */
 	/// the default storage prefix used by MultiMC
 	static QString defaultStoragePrefix();
@@ -1,7 +1,9 @@
 #include "MinecraftInstance.h"
 #include <minecraft/launch/CreateServerResourcePacksFolder.h>
 #include <minecraft/launch/ExtractNatives.h>
+#include <minecraft/launch/ReconstructAssets.h>
 #include <minecraft/launch/PrintInstanceInfo.h>
+#include "minecraft/MinecraftLog.h"
 #include <settings/Setting.h>
 #include "settings/SettingsObject.h"
 #include "Env.h"
@@ -101,11 +103,14 @@ MinecraftInstance::MinecraftInstance(SettingsObjectPtr globalSettings, SettingsO
 	// Minecraft launch method
 	auto launchMethodOverride = m_settings->registerSetting("OverrideMCLaunchMethod", false);
 	m_settings->registerOverride(globalSettings->getSetting("MCLaunchMethod"), launchMethodOverride);
+
+	// Assets
+	m_settings->registerPassthrough(globalSettings->getSetting("VerifyAssets"), nullptr);
 }
 
 void MinecraftInstance::init()
 {
-	createProfile();
+	// the component list is created by getComponentList() when something needs it
 }
 
 QString MinecraftInstance::typeName() const
@@ -138,33 +143,65 @@ void MinecraftInstance::createProfile()
 
 void MinecraftInstance::reloadProfile()
 {
-	m_profile->reload();
-	setVersionBroken(m_profile->getProblemSeverity() == ProblemSeverity::Error);
+	auto profile = getComponentList();
+	profile->reload();
+	setVersionBroken(profile->getProblemSeverity() == ProblemSeverity::Error);
 	emit versionReloaded();
 }
 
 void MinecraftInstance::clearProfile()
 {
-	m_profile->clear();
+	if (m_profile)
+	{
+		m_profile->clear();
+	}
 	emit versionReloaded();
 }
 
 std::shared_ptr<ComponentList> MinecraftInstance::getComponentList() const
 {
+	if (!m_profile)
+	{
+		const_cast<MinecraftInstance *>(this)->createProfile();
+	}
 	return m_profile;
 }
 
-QSet<QString> MinecraftInstance::traits() const
+namespace
 {
-	auto version = getComponentList();
-	if (!version)
+template <typename T>
+void releaseUnused(std::shared_ptr<T> &ptr)
+{
+	// something else (a page, a task) still uses it - keep it
+	if (ptr && ptr.use_count() == 1)
 	{
-		return {"version-incomplete"};
+		ptr.reset();
 	}
-	else
+}
+}
+
+void MinecraftInstance::releaseResources()
+{
+	if (isRunning())
 	{
-		return version->getTraits();
+		return;
 	}
+	releaseUnused(m_profile);
+	releaseUnused(m_loader_mod_list);
+	releaseUnused(m_core_mod_list);
+	releaseUnused(m_resource_pack_list);
+	releaseUnused(m_texture_pack_list);
+	releaseUnused(m_world_list);
+}
+
+QSet<QString> MinecraftInstance::traits() const
+{
+	// an unloaded profile has no traits, there is no point in creating one to find out
+	if (!m_profile)
+	{
+		return {};
+	}
+	return m_profile->getTraits();
 }
 
 QString MinecraftInstance::minecraftRoot() const
@@ -254,20 +291,20 @@ QStringList MinecraftInstance::getClassPath() const
 {
 	QStringList jars, nativeJars;
 	auto javaArchitecture = settings()->get("JavaArchitecture").toString();
-	m_profile->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
+	getComponentList()->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
 	return jars;
 }
 
 QString MinecraftInstance::getMainClass() const
 {
-	return m_profile->getMainClass();
+	return getComponentList()->getMainClass();
 }
 
 QStringList MinecraftInstance::getNativeJars() const
 {
 	QStringList jars, nativeJars;
 	auto javaArchitecture = settings()->get("JavaArchitecture").toString();
-	m_profile->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
+	getComponentList()->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
 	return nativeJars;
 }
 
@@ -298,7 +335,7 @@ QStringList MinecraftInstance::javaArguments() const
 	args << "-Xdock:icon=icon.png";
 	args << QString("-Xdock:name=\"%1\"").arg(windowTitle());
 #endif
-	auto traits = m_profile->getTraits();
+	auto traits = getComponentList()->getTraits();
 	// HACK: fix issues on macOS with 1.13 snapshots
 	// NOTE: Oracle Java option. if there are alternate jvm implementations, this would be the place to customize this for them
 #ifdef Q_OS_MAC
@@ -395,8 +432,8 @@ static QString replaceTokensIn(QString text, QMap<QString, QString> with)
 
 QStringList MinecraftInstance::processMinecraftArgs(AuthSessionPtr session) const
 {
-	QString args_pattern = m_profile->getMinecraftArguments();
-	for (auto tweaker : m_profile->getTweakers())
+	QString args_pattern = getComponentList()->getMinecraftArguments();
+	for (auto tweaker : getComponentList()->getTweakers())
 	{
 		args_pattern += " --tweakClass " + tweaker;
 	}
@@ -416,9 +453,9 @@ QStringList MinecraftInstance::processMinecraftArgs(AuthSessionPtr session) cons
 
 	// blatant self-promotion.
 	token_mapping["profile_name"] = token_mapping["version_name"] = "MultiMC5";
-	if(m_profile->isVanilla())
+	if(getComponentList()->isVanilla())
 	{
-		token_mapping["version_type"] = m_profile->getMinecraftVersionType();
+		token_mapping["version_type"] = getComponentList()->getMinecraftVersionType();
 	}
 	else
 	{
@@ -428,9 +465,9 @@ QStringList MinecraftInstance::processMinecraftArgs(AuthSessionPtr session) cons
 	QString absRootDir = QDir(minecraftRoot()).absolutePath();
 	token_mapping["game_directory"] = absRootDir;
 	QString absAssetsDir = QDir("assets/").absolutePath();
-	auto assets = m_profile->getMinecraftAssets();
-	// FIXME: this is wrong and should be run as an async task
-	token_mapping["game_assets"] = AssetsUtils::reconstructAssets(assets->id).absolutePath();
+	auto assets = getComponentList()->getMinecraftAssets();
+	// built by the ReconstructAssets launch step
+	token_mapping["game_assets"] = AssetsUtils::getAssetsDir(assets->id).absolutePath();
 
 	// 1.7.3+ assets tokens
 	token_mapping["assets_root"] = absAssetsDir;
@@ -456,7 +493,7 @@ QString MinecraftInstance::createLaunchScript(AuthSessionPtr session)
 	{
 		launchScript += "mainClass " + mainClass + "\n";
 	}
-	auto appletClass = m_profile->getAppletClass();
+	auto appletClass = getComponentList()->getAppletClass();
 	if (!appletClass.isEmpty())
 	{
 		launchScript += "appletClass " + appletClass + "\n";
@@ -492,7 +529,7 @@ QString MinecraftInstance::createLaunchScript(AuthSessionPtr session)
 	{
 		QStringList jars, nativeJars;
 		auto javaArchitecture = settings()->get("JavaArchitecture").toString();
-		m_profile->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
+		getComponentList()->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
 		for(auto file: jars)
 		{
 			launchScript += "cp " + file + "\n";
@@ -504,7 +541,7 @@ QString MinecraftInstance::createLaunchScript(AuthSessionPtr session)
 		launchScript += "natives " + getNativePath() + "\n";
 	}
 
-	for (auto trait : m_profile->getTraits())
+	for (auto trait : getComponentList()->getTraits())
 	{
 		launchScript += "traits " + trait + "\n";
 	}
@@ -536,7 +573,7 @@ QStringList MinecraftInstance::verboseDescription(AuthSessionPtr session)
 		out << "Libraries:";
 		QStringList jars, nativeJars;
 		auto javaArchitecture = settings()->get("JavaArchitecture").toString();
-		m_profile->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
+		getComponentList()->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
 		auto printLibFile = [&](const QString & path)
 		{
 			QFileInfo info(path);
@@ -594,7 +631,7 @@ QStringList MinecraftInstance::verboseDescription(AuthSessionPtr session)
 		out << "";
 	}
 
-	auto & jarMods = m_profile->getJarMods();
+	auto & jarMods = getComponentList()->getJarMods();
 	if(jarMods.size())
 	{
 		out << "Jar Mods:";
@@ -674,49 +711,7 @@ QMap<QString, QString> MinecraftInstance::createCensorFilterFromSession(AuthSess
 
 MessageLevel::Enum MinecraftInstance::guessLevel(const QString &line, MessageLevel::Enum level)
 {
-	QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
-	auto match = re.match(line);
-	if(match.hasMatch())
-	{
-		// New style logs from log4j
-		QString timestamp = match.captured("timestamp");
-		QString levelStr = match.captured("level");
-		if(levelStr == "INFO")
-			level = MessageLevel::Message;
-		if(levelStr == "WARN")
-			level = MessageLevel::Warning;
-		if(levelStr == "ERROR")
-			level = MessageLevel::Error;
-		if(levelStr == "FATAL")
-			level = MessageLevel::Fatal;
-		if(levelStr == "TRACE" || levelStr == "DEBUG")
-			level = MessageLevel::Debug;
-	}
-	else
-	{
-		// Old style forge logs
-		if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") ||
-			line.contains("[FINER]") || line.contains("[FINEST]"))
-			level = MessageLevel::Message;
-		if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
-			level = MessageLevel::Error;
-		if (line.contains("[WARNING]"))
-			level = MessageLevel::Warning;
-		if (line.contains("[DEBUG]"))
-			level = MessageLevel::Debug;
-	}
-	if (line.contains("overwriting existing"))
-		return MessageLevel::Fatal;
-	//NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
-	static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
-	if (line.contains("Exception in thread")
-		|| line.contains(QRegularExpression("\\s+at " + javaSymbol))
-		|| line.contains(QRegularExpression("Caused by: " + javaSymbol))
-		|| line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)"))
-		|| line.contains(QRegularExpression("... \\d+ more$"))
-		)
-		return MessageLevel::Error;
-	return level;
+	return MinecraftLog::guessLevel(line, level);
 }
 
 IPathMatcher::Ptr MinecraftInstance::getLogFileMatcher()
@@ -840,6 +835,12 @@ std::shared_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPtr s
 		process->appendStep(step);
 	}
 
+	// build the virtual assets folder if needed
+	{
+		auto step = std::make_shared<ReconstructAssets>(pptr);
+		process->appendStep(step);
+	}
+
 	// extract native jars if needed
 	{
 		auto step = std::make_shared<ExtractNatives>(pptr);
@@ -909,7 +910,7 @@ bool MinecraftInstance::setComponentVersion(const QString& uid, const QString& v
 	{
 		settings()->set("LiteloaderVersion", version);
 	}
-	if(getComponentList())
+	if(m_profile)
 	{
 		clearProfile();
 	}
@@ -942,7 +943,7 @@ std::shared_ptr<ModList> MinecraftInstance::loaderModList() const
 {
 	if (!m_loader_mod_list)
 	{
-		m_loader_mod_list.reset(new ModList(loaderModsDir()));
+		m_loader_mod_list.reset(new ModList(loaderModsDir(), FS::PathCombine(instanceRoot(), "mmc-cache", "loadermods.json")));
 	}
 	m_loader_mod_list->update();
 	return m_loader_mod_list;
@@ -952,7 +953,7 @@ std::shared_ptr<ModList> MinecraftInstance::coreModList() const
 {
 	if (!m_core_mod_list)
 	{
-		m_core_mod_list.reset(new ModList(coreModsDir()));
+		m_core_mod_list.reset(new ModList(coreModsDir(), FS::PathCombine(instanceRoot(), "mmc-cache", "coremods.json")));
 	}
 	m_core_mod_list->update();
 	return m_core_mod_list;
@@ -962,7 +963,7 @@ std::shared_ptr<ModList> MinecraftInstance::resourcePackList() const
 {
 	if (!m_resource_pack_list)
 	{
-		m_resource_pack_list.reset(new ModList(resourcePacksDir()));
+		m_resource_pack_list.reset(new ModList(resourcePacksDir(), FS::PathCombine(instanceRoot(), "mmc-cache", "resourcepacks.json")));
 	}
 	m_resource_pack_list->update();
 	return m_resource_pack_list;
@@ -972,7 +973,7 @@ std::shared_ptr<ModList> MinecraftInstance::texturePackList() const
 {
 	if (!m_texture_pack_list)
 	{
-		m_texture_pack_list.reset(new ModList(texturePacksDir()));
+		m_texture_pack_list.reset(new ModList(texturePacksDir(), FS::PathCombine(instanceRoot(), "mmc-cache", "texturepacks.json")));
 	}
 	m_texture_pack_list->update();
 	return m_texture_pack_list;
@@ -990,7 +991,7 @@ std::shared_ptr<WorldList> MinecraftInstance::worldList() const
 QList< Mod > MinecraftInstance::getJarMods() const
 {
 	QList<Mod> mods;
-	for (auto jarmod : m_profile->getJarMods())
+	for (auto jarmod : getComponentList()->getJarMods())
 	{
 		QStringList jar, temp1, temp2, temp3;
 		jarmod->getApplicableFiles(currentSystem, jar, temp1, temp2, temp3, jarmodsPath().absolutePath());
@@ -56,6 +56,7 @@ public:
 	void reloadProfile();
 	void clearProfile();
 	bool reload() override;
+	void releaseResources() override;
 
 
 	//////  Mod Lists  //////
@@ -114,7 +115,7 @@ private:
 	QString prettifyTimeDuration(int64_t duration);
 
 protected: // data
-	std::shared_ptr<ComponentList> m_profile;
+	mutable std::shared_ptr<ComponentList> m_profile;
 	mutable std::shared_ptr<ModList> m_loader_mod_list;
 	mutable std::shared_ptr<ModList> m_core_mod_list;
 	mutable std::shared_ptr<ModList> m_resource_pack_list;
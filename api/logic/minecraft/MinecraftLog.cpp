@@ -0,0 +1,272 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MinecraftLog.h"
+
+/*
+ * The scanner matches what these used to, one after another:
+ *
+ * log4j:          \[(?<timestamp>[0-9:]+)\] \[[^/]+/(?<level>[^\]]+)\]
+ * stack traces:   \s+at <symbol>
+ *                 Caused by: <symbol>
+ *                 ([a-zA-Z_$][a-zA-Z\d_$]*\.)+[a-zA-Z_$]?[a-zA-Z\d_$]*(Exception|Error|Throwable)
+ *                 ... \d+ more$
+ * where <symbol> is ([a-zA-Z_$][a-zA-Z\d_$]*\.)+[a-zA-Z_$][a-zA-Z\d_$]*
+ */
+namespace
+{
+inline bool isIdentStart(ushort c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '$';
+}
+
+inline bool isIdentPart(ushort c)
+{
+	return isIdentStart(c) || (c >= '0' && c <= '9');
+}
+
+inline bool isSpace(ushort c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+struct Line
+{
+	const QChar *data;
+	int size;
+
+	ushort at(int i) const
+	{
+		return i < size ? data[i].unicode() : 0;
+	}
+
+	bool hasAt(int i, const char *text, int length) const
+	{
+		if (i + length > size)
+			return false;
+		for (int j = 0; j < length; j++)
+		{
+			if (data[i + j].unicode() != ushort(text[j]))
+				return false;
+		}
+		return true;
+	}
+
+	// a dotted Java name with at least two parts starts at i
+	bool symbolAt(int i) const
+	{
+		if (!isIdentStart(at(i)))
+			return false;
+		while (isIdentPart(at(i)))
+			i++;
+		return at(i) == '.' && isIdentStart(at(i + 1));
+	}
+
+	// log4j "[<timestamp>] [<thread>/<level>]" starting at the '[' at i. Returns the level or an empty span.
+	bool log4jAt(int i, int &levelStart, int &levelEnd) const
+	{
+		int pos = i + 1;
+		while (pos < size && ((at(pos) >= '0' && at(pos) <= '9') || at(pos) == ':'))
+			pos++;
+		if (pos == i + 1 || !hasAt(pos, "] [", 3))
+			return false;
+		pos += 3;
+		if (at(pos) == '/')
+			return false;
+		while (pos < size && at(pos) != '/')
+			pos++;
+		if (pos >= size)
+			return false;
+		levelStart = ++pos;
+		while (pos < size && at(pos) != ']')
+			pos++;
+		if (pos >= size || pos == levelStart)
+			return false;
+		levelEnd = pos;
+		return true;
+	}
+
+	// "([a-zA-Z_$][a-zA-Z\d_$]*\.)+[a-zA-Z_$]?[a-zA-Z\d_$]*(Exception|Error|Throwable)" around the '.' at i
+	bool exceptionNameAt(int i) const
+	{
+		// the part before the dot needs at least one non-digit
+		bool start = false;
+		for (int j = i - 1; j >= 0 && isIdentPart(at(j)); j--)
+		{
+			if (isIdentStart(at(j)))
+			{
+				start = true;
+				break;
+			}
+		}
+		if (!start)
+			return false;
+		// and the part after it has the suffix in it somewhere
+		for (int j = i + 1; j < size && isIdentPart(at(j)); j++)
+		{
+			ushort c = at(j);
+			if ((c == 'E' && (hasAt(j, "Exception", 9) || hasAt(j, "Error", 5))) || (c == 'T' && hasAt(j, "Throwable", 9)))
+				return true;
+		}
+		return false;
+	}
+
+	// "... \d+ more$"
+	bool endsWithMore() const
+	{
+		int pos = size - 5;
+		if (pos < 0 || !hasAt(pos, " more", 5))
+			return false;
+		int digits = pos;
+		while (digits > 0 && at(digits - 1) >= '0' && at(digits - 1) <= '9')
+			digits--;
+		if (digits == pos || digits < 1 || at(digits - 1) != ' ')
+			return false;
+		// three of anything but line breaks before the space
+		int dots = digits - 1;
+		if (dots < 3)
+			return false;
+		for (int j = dots - 3; j < dots; j++)
+		{
+			if (at(j) == '\n' || at(j) == '\r')
+				return false;
+		}
+		return true;
+	}
+};
+
+enum OldStyle
+{
+	OldNone = 0,
+	OldMessage = 1,
+	OldError = 2,
+	OldWarning = 4,
+	OldDebug = 8
+};
+
+// "[TAG]" at i
+int oldStyleAt(const Line &line, int i)
+{
+	struct Tag
+	{
+		const char *text;
+		int length;
+		OldStyle style;
+	};
+	static const Tag tags[] =
+	{
+		{"[INFO]", 6, OldMessage},
+		{"[CONFIG]", 8, OldMessage},
+		{"[FINE]", 6, OldMessage},
+		{"[FINER]", 7, OldMessage},
+		{"[FINEST]", 8, OldMessage},
+		{"[SEVERE]", 8, OldError},
+		{"[STDERR]", 8, OldError},
+		{"[WARNING]", 9, OldWarning},
+		{"[DEBUG]", 7, OldDebug}
+	};
+	int found = OldNone;
+	for (const auto &tag : tags)
+	{
+		if (line.hasAt(i, tag.text, tag.length))
+			found |= tag.style;
+	}
+	return found;
+}
+}
+
+namespace MinecraftLog
+{
+MessageLevel::Enum guessLevel(const QString &text, MessageLevel::Enum level)
+{
+	Line line{text.constData(), text.size()};
+
+	bool log4j = false;
+	int levelStart = 0, levelEnd = 0;
+	int oldStyle = OldNone;
+	bool fatal = false;
+	bool error = false;
+
+	for (int i = 0; i < line.size; i++)
+	{
+		switch (line.data[i].unicode())
+		{
+			case '[':
+				if (!log4j)
+					log4j = line.log4jAt(i, levelStart, levelEnd);
+				oldStyle |= oldStyleAt(line, i);
+				break;
+			case '.':
+				if (!error)
+					error = line.exceptionNameAt(i);
+				break;
+			case 'o':
+				if (!fatal)
+					fatal = line.hasAt(i, "overwriting existing", 20);
+				break;
+			case 'E':
+				if (!error)
+					error = line.hasAt(i, "Exception in thread", 19);
+				break;
+			case 'C':
+				if (!error)
+					error = line.hasAt(i, "Caused by: ", 11) && line.symbolAt(i + 11);
+				break;
+			case ' ':
+			case '\t':
+			case '\n':
+			case '\v':
+			case '\f':
+			case '\r':
+				if (!error)
+					error = line.hasAt(i + 1, "at ", 3) && line.symbolAt(i + 4);
+				break;
+		}
+	}
+
+	if (log4j)
+	{
+		// New style logs from log4j
+		auto levelStr = QStringRef(&text, levelStart, levelEnd - levelStart);
+		if (levelStr == QLatin1String("INFO"))
+			level = MessageLevel::Message;
+		else if (levelStr == QLatin1String("WARN"))
+			level = MessageLevel::Warning;
+		else if (levelStr == QLatin1String("ERROR"))
+			level = MessageLevel::Error;
+		else if (levelStr == QLatin1String("FATAL"))
+			level = MessageLevel::Fatal;
+		else if (levelStr == QLatin1String("TRACE") || levelStr == QLatin1String("DEBUG"))
+			level = MessageLevel::Debug;
+	}
+	else if (oldStyle)
+	{
+		// Old style forge logs, the later checks used to win
+		if (oldStyle & OldDebug)
+			level = MessageLevel::Debug;
+		else if (oldStyle & OldWarning)
+			level = MessageLevel::Warning;
+		else if (oldStyle & OldError)
+			level = MessageLevel::Error;
+		else
+			level = MessageLevel::Message;
+	}
+	if (fatal)
+		return MessageLevel::Fatal;
+	if (error || line.endsWithMore())
+		return MessageLevel::Error;
+	return level;
+}
+}
@@ -0,0 +1,33 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include "MessageLevel.h"
+
+#include "multimc_logic_export.h"
+
+namespace MinecraftLog
+{
+/**
+ * Guess the level of a line of Minecraft output, starting from the level it came with.
+ *
+ * Understands log4j lines ("[12:34:56] [Thread/LEVEL]"), the old Forge/JUL style tags ("[INFO]", "[SEVERE]", ...)
+ * and Java stack traces. This is a hand written scanner that looks at the line once - it runs for every
+ * line the game prints, which can be thousands per second.
+ */
+MULTIMC_LOGIC_EXPORT MessageLevel::Enum guessLevel(const QString &line, MessageLevel::Enum level);
+}
@@ -0,0 +1,126 @@
+#include <QTest>
+#include <QRegularExpression>
+#include "TestUtil.h"
+
+#include "minecraft/MinecraftLog.h"
+
+Q_DECLARE_METATYPE(MessageLevel::Enum)
+
+class MinecraftLogTest : public QObject
+{
+	Q_OBJECT
+private:
+	// what MinecraftInstance::guessLevel used to do, as the reference and the baseline for the benchmark
+	static MessageLevel::Enum guessLevelRegex(const QString &line, MessageLevel::Enum level)
+	{
+		QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
+		auto match = re.match(line);
+		if(match.hasMatch())
+		{
+			QString levelStr = match.captured("level");
+			if(levelStr == "INFO")
+				level = MessageLevel::Message;
+			if(levelStr == "WARN")
+				level = MessageLevel::Warning;
+			if(levelStr == "ERROR")
+				level = MessageLevel::Error;
+			if(levelStr == "FATAL")
+				level = MessageLevel::Fatal;
+			if(levelStr == "TRACE" || levelStr == "DEBUG")
+				level = MessageLevel::Debug;
+		}
+		else
+		{
+			if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") ||
+				line.contains("[FINER]") || line.contains("[FINEST]"))
+				level = MessageLevel::Message;
+			if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
+				level = MessageLevel::Error;
+			if (line.contains("[WARNING]"))
+				level = MessageLevel::Warning;
+			if (line.contains("[DEBUG]"))
+				level = MessageLevel::Debug;
+		}
+		if (line.contains("overwriting existing"))
+			return MessageLevel::Fatal;
+		static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+		if (line.contains("Exception in thread")
+			|| line.contains(QRegularExpression("\\s+at " + javaSymbol))
+			|| line.contains(QRegularExpression("Caused by: " + javaSymbol))
+			|| line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)"))
+			|| line.contains(QRegularExpression("... \\d+ more$"))
+			)
+			return MessageLevel::Error;
+		return level;
+	}
+
+	QStringList readLog()
+	{
+		QFile file(QFINDTESTDATA("testdata/client-log.txt"));
+		if (!file.open(QIODevice::ReadOnly))
+			return {};
+		return QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+	}
+
+private
+slots:
+	void test_matchesRegex_data()
+	{
+		QTest::addColumn<QString>("line");
+		QTest::addColumn<MessageLevel::Enum>("level");
+		auto lines = readLog();
+		QVERIFY(lines.size() > 50);
+		for (int i = 0; i < lines.size(); i++)
+		{
+			QTest::newRow(QString("line %1 stdout").arg(i + 1).toUtf8()) << lines[i] << MessageLevel::StdOut;
+			QTest::newRow(QString("line %1 stderr").arg(i + 1).toUtf8()) << lines[i] << MessageLevel::StdErr;
+		}
+	}
+	void test_matchesRegex()
+	{
+		QFETCH(QString, line);
+		QFETCH(MessageLevel::Enum, level);
+		QCOMPARE(int(MinecraftLog::guessLevel(line, level)), int(guessLevelRegex(line, level)));
+	}
+
+	void test_benchmark_data()
+	{
+		QTest::addColumn<bool>("regex");
+		QTest::newRow("QRegularExpression") << true;
+		QTest::newRow("scanner") << false;
+	}
+	void test_benchmark()
+	{
+		QFETCH(bool, regex);
+		auto lines = readLog();
+		// lines per iteration: the log, 20 times over
+		QStringList input;
+		for (int i = 0; i < 20; i++)
+		{
+			input += lines;
+		}
+		int errors = 0;
+		if (regex)
+		{
+			QBENCHMARK
+			{
+				for (auto &line : input)
+					errors += guessLevelRegex(line, MessageLevel::StdOut) == MessageLevel::Error;
+			}
+		}
+		else
+		{
+			QBENCHMARK
+			{
+				for (auto &line : input)
+					errors += MinecraftLog::guessLevel(line, MessageLevel::StdOut) == MessageLevel::Error;
+			}
+		}
+		qDebug() << input.size() << "lines per iteration";
+		QVERIFY(errors > 0);
+	}
+};
+
+QTEST_GUILESS_MAIN(MinecraftLogTest)
+
+#include "MinecraftLog_test.moc"
@@ -88,7 +88,8 @@ OneSixUpdate::OneSixUpdate(MinecraftInstance *inst, QObject *parent) : Task(pare
 
 	// assets update
 	{
-		m_tasks.append(std::make_shared<AssetUpdateTask>(m_inst));
+		auto verify = m_inst->settings()->get("VerifyAssets").toBool();
+		m_tasks.append(std::make_shared<AssetUpdateTask>(m_inst, verify));
 	}
 }
 
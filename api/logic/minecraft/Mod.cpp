@@ -27,13 +27,22 @@
 #include <FileSystem.h>
 #include <QDebug>
 
-Mod::Mod(const QFileInfo &file)
+Mod::Mod(const QFileInfo &file, bool readDetails)
 {
-	repath(file);
+	setFile(file);
+	if (readDetails)
+	{
+		this->readDetails();
+	}
 	m_changedDateTime = file.lastModified();
 }
 
 void Mod::repath(const QFileInfo &file)
+{
+	setFile(file);
+}
+
+void Mod::setFile(const QFileInfo &file)
 {
 	m_file = file;
 	QString name_base = file.fileName();
@@ -74,7 +83,12 @@ void Mod::repath(const QFileInfo &file)
 		}
 		m_name = name_base;
 	}
+	m_detailsPending = m_type == MOD_ZIPFILE || m_type == MOD_FOLDER || m_type == MOD_LITEMOD;
+}
 
+void Mod::readDetails()
+{
+	m_detailsPending = false;
 	if (m_type == MOD_ZIPFILE)
 	{
 		QuaZip zip(m_file.filePath());
@@ -149,6 +163,40 @@ void Mod::repath(const QFileInfo &file)
 	}
 }
 
+QJsonObject Mod::detailsToJson() const
+{
+	QJsonObject details;
+	auto put = [&](const char *key, const QString &value)
+	{
+		if (!value.isEmpty())
+			details.insert(key, value);
+	};
+	put("modid", m_mod_id);
+	put("name", m_name);
+	put("version", m_version);
+	put("mcversion", m_mcversion);
+	put("url", m_homeurl);
+	put("updateUrl", m_updateurl);
+	put("description", m_description);
+	put("authors", m_authors);
+	put("credits", m_credits);
+	return details;
+}
+
+void Mod::detailsFromJson(const QJsonObject &details)
+{
+	m_mod_id = details.value("modid").toString();
+	m_name = details.value("name").toString(m_name);
+	m_version = details.value("version").toString();
+	m_mcversion = details.value("mcversion").toString();
+	m_homeurl = details.value("url").toString();
+	m_updateurl = details.value("updateUrl").toString();
+	m_description = details.value("description").toString();
+	m_authors = details.value("authors").toString();
+	m_credits = details.value("credits").toString();
+	m_detailsPending = false;
+}
+
 // NEW format
 // https://github.com/MinecraftForge/FML/wiki/FML-mod-information-file/6f62b37cea040daf350dc253eae6326dd9c822c3
 
@@ -293,6 +341,7 @@ bool Mod::replace(Mod &with)
 		m_credits = with.m_credits;
 		m_homeurl = with.m_homeurl;
 		m_type = with.m_type;
+		m_detailsPending = with.m_detailsPending;
 		m_file.refresh();
 	}
 	return success;
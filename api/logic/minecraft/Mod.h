@@ -16,6 +16,7 @@
 #pragma once
 #include <QFileInfo>
 #include <QDateTime>
+#include <QJsonObject>
 
 class Mod
 {
@@ -29,7 +30,8 @@ public:
 		MOD_LITEMOD, //!< The mod is a litemod
 	};
 
-	Mod(const QFileInfo &file);
+	/// With readDetails unset, only what the file name says is known - see readDetails()
+	Mod(const QFileInfo &file, bool readDetails = true);
 
 	QFileInfo filename() const
 	{
@@ -105,13 +107,26 @@ public:
 	// replace this mod with a copy of the other
 	bool replace(Mod &with);
 	// change the mod's filesystem path (used by mod lists for *MAGIC* purposes)
+	// the details are pending again afterwards, see readDetails()
 	void repath(const QFileInfo &file);
 
+	// read the name, version, etc. from inside the mod. This opens zip files, so it can be slow.
+	void readDetails();
+	// true until the details are read (or set from a cache), if there are any to read
+	bool detailsPending() const
+	{
+		return m_detailsPending;
+	}
+	// the details, as read by readDetails, for caching
+	QJsonObject detailsToJson() const;
+	void detailsFromJson(const QJsonObject &details);
+
 	// WEAK compare operator - used for replacing mods
 	bool operator==(const Mod &other) const;
 	bool strongCompare(const Mod &other) const;
 
 private:
+	void setFile(const QFileInfo &file);
 	void ReadMCModInfo(QByteArray contents);
 	void ReadForgeInfo(QByteArray contents);
 	void ReadLiteModInfo(QByteArray contents);
@@ -139,4 +154,5 @@ protected:
 	QString m_credits;
 
 	ModType m_type;
+	bool m_detailsPending = false;
 };
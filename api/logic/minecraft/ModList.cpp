@@ -19,17 +19,34 @@
 #include <QUrl>
 #include <QUuid>
 #include <QString>
-#include <QFileSystemWatcher>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QSet>
+#include <QMap>
+#include <QtConcurrentMap>
 #include <QDebug>
+#include <algorithm>
+#include <functional>
 
-ModList::ModList(const QString &dir) : QAbstractListModel(), m_dir(dir)
+ModList::ModList(const QString &dir, const QString &cacheFile)
+	: QAbstractListModel(), m_dir(dir), m_cacheFile(cacheFile)
 {
 	FS::ensureFolderPathExists(m_dir.absolutePath());
 	m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs |
 					QDir::NoSymLinks);
 	m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
-	m_watcher = new QFileSystemWatcher(this);
-	connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChanged(QString)));
+	m_watcher = new DirectoryWatcher(this);
+	m_watcher->setDirectory(m_dir.absolutePath());
+	connect(m_watcher, &DirectoryWatcher::changed, this, &ModList::directoryChanged);
+	connect(&m_detailsWatcher, &QFutureWatcher<Mod>::resultReadyAt, this, &ModList::detailsReady);
+	connect(&m_detailsWatcher, &QFutureWatcher<Mod>::finished, this, &ModList::detailsFinished);
+}
+
+ModList::~ModList()
+{
+	m_detailsWatcher.cancel();
+	m_detailsWatcher.waitForFinished();
+	saveCache();
 }
 
 void ModList::startWatching()
@@ -39,7 +56,7 @@ void ModList::startWatching()
 
 	update();
 
-	is_watching = m_watcher->addPath(m_dir.absolutePath());
+	is_watching = m_watcher->start();
 	if (is_watching)
 	{
 		qDebug() << "Started watching " << m_dir.absolutePath();
@@ -55,15 +72,9 @@ void ModList::stopWatching()
 	if(!is_watching)
 		return;
 
-	is_watching = !m_watcher->removePath(m_dir.absolutePath());
-	if (!is_watching)
-	{
-		qDebug() << "Stopped watching " << m_dir.absolutePath();
-	}
-	else
-	{
-		qDebug() << "Failed to stop watching " << m_dir.absolutePath();
-	}
+	m_watcher->stop();
+	is_watching = false;
+	qDebug() << "Stopped watching " << m_dir.absolutePath();
 }
 
 bool ModList::update()
@@ -71,53 +82,329 @@ bool ModList::update()
 	if (!isValid())
 		return false;
 
-	QList<Mod> orderedMods;
-	QList<Mod> newMods;
+	loadCache();
+
 	m_dir.refresh();
 	auto folderContents = m_dir.entryInfoList();
-	bool orderOrStateChanged = false;
 
-	// if there are any untracked files...
-	if (folderContents.size())
+	// What the list should look like. Mods that didn't change on disk are kept as they are.
+	QHash<QString, int> oldRows;
+	for (int i = 0; i < mods.size(); i++)
 	{
-		// the order surely changed!
-		for (auto entry : folderContents)
-		{
-			newMods.append(Mod(entry));
-		}
-		orderedMods.append(newMods);
-		orderOrStateChanged = true;
+		oldRows.insert(mods[i].filename().absoluteFilePath(), i);
 	}
-	// otherwise, if we were already tracking some mods
-	else if (mods.size())
+	QList<Mod> newMods;
+	QSet<QString> newPaths;
+	for (auto &entry : folderContents)
 	{
-		// if the number doesn't match, order changed.
-		if (mods.size() != orderedMods.size())
-			orderOrStateChanged = true;
-		// if it does match, compare the mods themselves
-		else
-			for (int i = 0; i < mods.size(); i++)
+		auto path = entry.absoluteFilePath();
+		newPaths.insert(path);
+		auto iter = oldRows.constFind(path);
+		if (iter != oldRows.constEnd())
+		{
+			const auto &old = mods[iter.value()];
+			if (old.filename().size() == entry.size() && old.dateTimeChanged() == entry.lastModified())
 			{
-				if (!mods[i].strongCompare(orderedMods[i]))
-				{
-					orderOrStateChanged = true;
-					break;
-				}
+				newMods.append(old);
+				continue;
 			}
+		}
+		Mod mod(entry, false);
+		applyCached(mod);
+		newMods.append(mod);
+	}
+
+	bool listChanged = false;
+
+	// drop what's gone
+	for (int i = mods.size() - 1; i >= 0; i--)
+	{
+		if (!newPaths.contains(mods[i].filename().absoluteFilePath()))
+		{
+			beginRemoveRows(QModelIndex(), i, i);
+			mods.removeAt(i);
+			endRemoveRows();
+			m_rowsValid = false;
+			listChanged = true;
+		}
+	}
+
+	// put the rest in order, adding new mods and replacing changed ones
+	for (int i = 0; i < newMods.size(); i++)
+	{
+		const auto &mod = newMods[i];
+		auto path = mod.filename().absoluteFilePath();
+		if (!oldRows.contains(path))
+		{
+			beginInsertRows(QModelIndex(), i, i);
+			mods.insert(i, mod);
+			endInsertRows();
+			m_rowsValid = false;
+			listChanged = true;
+			continue;
+		}
+		// the list is usually in folder order already, only look it up when it isn't
+		int row = mods[i].filename().absoluteFilePath() == path ? i : rowOf(path);
+		if (row != i)
+		{
+			beginMoveRows(QModelIndex(), row, row, QModelIndex(), i);
+			mods.move(row, i);
+			endMoveRows();
+			m_rowsValid = false;
+			listChanged = true;
+		}
+		auto &current = mods[i];
+		if (current.filename().size() != mod.filename().size() || current.dateTimeChanged() != mod.dateTimeChanged())
+		{
+			current = mod;
+			emit dataChanged(index(i, 0), index(i, NUM_COLUMNS - 1));
+			listChanged = true;
+		}
 	}
-	beginResetModel();
-	mods.swap(orderedMods);
-	endResetModel();
-	if (orderOrStateChanged)
+
+	scanPending();
+	if (listChanged)
 	{
 		emit changed();
 	}
 	return true;
 }
 
-void ModList::directoryChanged(QString path)
+int ModList::rowOf(const QString &path) const
 {
-	update();
+	if (!m_rowsValid)
+	{
+		m_rows.clear();
+		m_rows.reserve(mods.size());
+		for (int i = 0; i < mods.size(); i++)
+		{
+			m_rows.insert(mods[i].filename().absoluteFilePath(), i);
+		}
+		m_rowsValid = true;
+	}
+	return m_rows.value(path, -1);
+}
+
+void ModList::applyCached(Mod &mod) const
+{
+	if (!mod.detailsPending() || mod.type() == Mod::MOD_FOLDER)
+		return;
+	auto file = mod.filename();
+	auto iter = m_cache.constFind(file.fileName());
+	if (iter == m_cache.constEnd())
+		return;
+	if (iter->size != file.size() || iter->timestamp != file.lastModified().toMSecsSinceEpoch())
+		return;
+	mod.detailsFromJson(iter->details);
+}
+
+void ModList::scanPending()
+{
+	// the rest will be picked up when the running scan is done
+	if (m_detailsWatcher.isRunning())
+		return;
+
+	QStringList pending;
+	for (auto &mod : mods)
+	{
+		if (mod.detailsPending())
+			pending.append(mod.filename().absoluteFilePath());
+	}
+	if (pending.isEmpty())
+		return;
+
+	// only the paths cross threads, the mods are made from scratch there
+	std::function<Mod(const QString &)> read = [](const QString &path)
+	{
+		return Mod(QFileInfo(path));
+	};
+	m_detailsWatcher.setFuture(QtConcurrent::mapped(pending, read));
+}
+
+void ModList::detailsReady(int resultIndex)
+{
+	auto result = m_detailsWatcher.resultAt(resultIndex);
+	auto file = result.filename();
+	int row = rowOf(file.absoluteFilePath());
+	if (row < 0)
+		return;
+
+	// the file changed again while it was being read
+	auto &mod = mods[row];
+	if (!mod.detailsPending() || mod.filename().size() != file.size() ||
+		mod.dateTimeChanged() != result.dateTimeChanged())
+		return;
+
+	mod = result;
+	emit dataChanged(index(row, 0), index(row, NUM_COLUMNS - 1));
+
+	if (mod.type() != Mod::MOD_FOLDER)
+	{
+		CacheEntry entry;
+		entry.size = file.size();
+		entry.timestamp = mod.dateTimeChanged().toMSecsSinceEpoch();
+		entry.details = mod.detailsToJson();
+		m_cache.insert(file.fileName(), entry);
+		m_cacheDirty = true;
+	}
+}
+
+void ModList::detailsFinished()
+{
+	if (m_detailsWatcher.isCanceled())
+		return;
+	saveCache();
+	scanPending();
+}
+
+void ModList::loadCache()
+{
+	if (m_cacheLoaded || m_cacheFile.isEmpty())
+		return;
+	m_cacheLoaded = true;
+
+	QFile file(m_cacheFile);
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+	auto root = QJsonDocument::fromJson(file.readAll()).object();
+	if (root.value("formatVersion").toInt() != 1)
+		return;
+	for (auto value : root.value("mods").toArray())
+	{
+		auto object = value.toObject();
+		CacheEntry entry;
+		entry.size = object.value("size").toDouble();
+		entry.timestamp = object.value("timestamp").toDouble();
+		entry.details = object.value("details").toObject();
+		m_cache.insert(object.value("file").toString(), entry);
+	}
+}
+
+void ModList::saveCache()
+{
+	if (!m_cacheDirty || m_cacheFile.isEmpty())
+		return;
+	m_cacheDirty = false;
+
+	// only keep what's still there
+	QSet<QString> present;
+	for (auto &mod : mods)
+	{
+		present.insert(mod.filename().fileName());
+	}
+	QJsonArray array;
+	for (auto iter = m_cache.begin(); iter != m_cache.end();)
+	{
+		if (!present.contains(iter.key()))
+		{
+			iter = m_cache.erase(iter);
+			continue;
+		}
+		QJsonObject object;
+		object.insert("file", iter.key());
+		object.insert("size", double(iter->size));
+		object.insert("timestamp", double(iter->timestamp));
+		object.insert("details", iter->details);
+		array.append(object);
+		iter++;
+	}
+	QJsonObject root;
+	root.insert("formatVersion", 1);
+	root.insert("mods", array);
+	try
+	{
+		FS::write(m_cacheFile, QJsonDocument(root).toJson(QJsonDocument::Compact));
+	}
+	catch (Exception & e)
+	{
+		qWarning() << "Couldn't write the mod cache" << m_cacheFile << ":" << e.what();
+	}
+}
+
+void ModList::directoryChanged(const DirectoryWatcher::Changes &changes)
+{
+	loadCache();
+	bool listChanged = false;
+
+	// look up all the rows before any of them move
+	QSet<int> gone;
+	for (auto &name : changes.removed)
+	{
+		int row = rowOf(m_dir.absoluteFilePath(name));
+		if (row >= 0)
+			gone.insert(row);
+	}
+	// only the named files are looked at, their details go through the same background reads as in update()
+	QMap<QString, Mod> added;
+	for (auto &name : changes.changed + changes.added)
+	{
+		QFileInfo entry(m_dir.absoluteFilePath(name));
+		int row = rowOf(entry.absoluteFilePath());
+		// same as the folder filter: readable files and folders, no symlinks
+		if (!entry.exists() || !entry.isReadable() || entry.isSymLink())
+		{
+			if (row >= 0)
+				gone.insert(row);
+			continue;
+		}
+		// removed and back again, replace it in place
+		bool returned = row >= 0 && gone.remove(row);
+		if (row >= 0 && !returned)
+		{
+			auto &current = mods[row];
+			if (current.filename().size() == entry.size() && current.dateTimeChanged() == entry.lastModified())
+				continue;
+		}
+		Mod mod(entry, false);
+		applyCached(mod);
+		if (row >= 0)
+		{
+			mods[row] = mod;
+			emit dataChanged(index(row, 0), index(row, NUM_COLUMNS - 1));
+			listChanged = true;
+		}
+		else
+		{
+			added.insert(entry.fileName(), mod);
+		}
+	}
+
+	// from the bottom up, so the other rows stay where they are
+	auto goneRows = gone.values();
+	std::sort(goneRows.begin(), goneRows.end(), std::greater<int>());
+	for (int row : goneRows)
+	{
+		beginRemoveRows(QModelIndex(), row, row);
+		mods.removeAt(row);
+		endRemoveRows();
+		m_rowsValid = false;
+		listChanged = true;
+	}
+	for (auto &mod : added)
+	{
+		int row = sortedRowFor(mod.filename().fileName());
+		beginInsertRows(QModelIndex(), row, row);
+		mods.insert(row, mod);
+		endInsertRows();
+		m_rowsValid = false;
+		listChanged = true;
+	}
+	scanPending();
+	if (listChanged)
+	{
+		emit changed();
+	}
+}
+
+int ModList::sortedRowFor(const QString &fileName) const
+{
+	// the rows are in this order already, find the first one that goes after the file
+	auto key = fileName.toLower();
+	auto after = std::upper_bound(mods.begin(), mods.end(), key, [](const QString &key, const Mod &mod)
+	{
+		return QString::localeAwareCompare(key, mod.filename().fileName().toLower()) < 0;
+	});
+	return int(after - mods.begin());
 }
 
 bool ModList::isValid()
@@ -136,7 +423,8 @@ bool ModList::installMod(const QString &filename)
 	{
 		return false;
 	}
-	Mod m(fileinfo);
+	// the type is all that's needed here, the details are read in the background once it's in the list
+	Mod m(fileinfo, false);
 	if (!m.valid())
 		return false;
 
@@ -174,7 +462,11 @@ bool ModList::enableMods(const QModelIndexList& indexes, bool enable)
 	for (auto i: indexes)
 	{
 		Mod &m = mods[i.row()];
-		m.enable(enable);
+		if (m.enable(enable))
+		{
+			// the file was renamed
+			m_rowsValid = false;
+		}
 		emit dataChanged(i, i);
 	}
 	emit changed();
@@ -255,6 +547,7 @@ bool ModList::setData(const QModelIndex &index, const QVariant &value, int role)
 		auto &mod = mods[index.row()];
 		if (mod.enable(!mod.enabled()))
 		{
+			m_rowsValid = false;
 			emit dataChanged(index, index);
 			return true;
 		}
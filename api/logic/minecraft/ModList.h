@@ -19,18 +19,24 @@
 #include <QString>
 #include <QDir>
 #include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QHash>
 
 #include "minecraft/Mod.h"
+#include "DirectoryWatcher.h"
 
 #include "multimc_logic_export.h"
 
 class LegacyInstance;
 class BaseInstance;
-class QFileSystemWatcher;
 
 /**
  * A legacy mod list.
  * Backed by a folder.
+ *
+ * The list itself is built from the folder contents right away. The details from inside the mods
+ * are read on the global thread pool and filled in as they come. If a cache file is given, the details
+ * are kept there, keyed by file name, size and timestamp, so unchanged mods don't have to be opened again.
  */
 class MULTIMC_LOGIC_EXPORT ModList : public QAbstractListModel
 {
@@ -44,7 +50,8 @@ public:
 		VersionColumn,
 		NUM_COLUMNS
 	};
-	ModList(const QString &dir);
+	ModList(const QString &dir, const QString &cacheFile = QString());
+	virtual ~ModList();
 
 	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 	virtual bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
@@ -108,14 +115,41 @@ public:
 
 private
 slots:
-	void directoryChanged(QString path);
+	void directoryChanged(const DirectoryWatcher::Changes &changes);
+	void detailsReady(int index);
+	void detailsFinished();
 
 signals:
 	void changed();
 
+private:
+	struct CacheEntry
+	{
+		qint64 size = 0;
+		qint64 timestamp = 0;
+		QJsonObject details;
+	};
+	void applyCached(Mod &mod) const;
+	void scanPending();
+	void loadCache();
+	void saveCache();
+	int rowOf(const QString &path) const;
+	// where a new file goes, in the order of the folder listing
+	int sortedRowFor(const QString &fileName) const;
+
 protected:
-	QFileSystemWatcher *m_watcher;
+	DirectoryWatcher *m_watcher;
 	bool is_watching = false;
 	QDir m_dir;
 	QList<Mod> mods;
+
+private:
+	QFutureWatcher<Mod> m_detailsWatcher;
+	QString m_cacheFile;
+	bool m_cacheLoaded = false;
+	bool m_cacheDirty = false;
+	QHash<QString, CacheEntry> m_cache;
+	// absolute path -> row, built again on the next lookup after rows move
+	mutable QHash<QString, int> m_rows;
+	mutable bool m_rowsValid = false;
 };
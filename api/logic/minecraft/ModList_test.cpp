@@ -46,6 +46,26 @@ slots:
 			verify(tempDir.path());
 		}
 	}
+
+	void test_updateAfterRename()
+	{
+		QTemporaryDir tempDir;
+		FS::write(FS::PathCombine(tempDir.path(), "a.zip"), "a");
+		FS::write(FS::PathCombine(tempDir.path(), "c.zip"), "c");
+		ModList m(tempDir.path());
+		QVERIFY(m.update());
+		QCOMPARE(int(m.size()), 2);
+
+		// renames the file, the rows have to follow
+		QVERIFY(m.enableMods({m.index(0)}, false));
+		FS::write(FS::PathCombine(tempDir.path(), "b.zip"), "b");
+		QVERIFY(m.update());
+		QCOMPARE(int(m.size()), 3);
+		QCOMPARE(m[0].filename().fileName(), QString("a.zip.disabled"));
+		QVERIFY(!m[0].enabled());
+		QCOMPARE(m[1].filename().fileName(), QString("b.zip"));
+		QCOMPARE(m[2].filename().fileName(), QString("c.zip"));
+	}
 };
 
 QTEST_GUILESS_MAIN(ModListTest)
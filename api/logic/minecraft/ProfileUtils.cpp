@@ -8,6 +8,10 @@
 #include <QJsonArray>
 #include <QRegularExpression>
 #include <QSaveFile>
+#include <QCache>
+#include <QCryptographicHash>
+#include <QMutex>
+#include <QMutexLocker>
 
 namespace ProfileUtils
 {
@@ -120,6 +124,54 @@ static VersionFilePtr guardedParseJson(const QJsonDocument & doc,const QString &
 	}
 }
 
+namespace
+{
+/*
+ * Version files parsed from disk, keyed by a hash of their contents.
+ *
+ * Every launch reloads the profile, and many instances carry identical patches (same Minecraft, same Forge).
+ * Successfully parsed files do not depend on where they were read from, so they are shared between all of them.
+ * Files that failed to parse are not cached - their problems name the file they came from.
+ */
+class ParsedFileCache
+{
+public:
+	VersionFilePtr get(const QByteArray &key)
+	{
+		QMutexLocker locker(&m_lock);
+		auto cached = m_files.object(key);
+		if (!cached)
+		{
+			return nullptr;
+		}
+		// callers adjust the top level fields of what they get, so they get their own copy
+		return std::make_shared<VersionFile>(**cached);
+	}
+	void insert(const QByteArray &key, const VersionFilePtr &file)
+	{
+		QMutexLocker locker(&m_lock);
+		m_files.insert(key, new VersionFilePtr(std::make_shared<VersionFile>(*file)));
+	}
+
+private:
+	QMutex m_lock;
+	QCache<QByteArray, VersionFilePtr> m_files {256};
+};
+
+ParsedFileCache &parsedFileCache()
+{
+	static ParsedFileCache cache;
+	return cache;
+}
+
+QByteArray parsedFileKey(const QByteArray &data, const bool requireOrder)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(data);
+	return hash.result() + (requireOrder ? '1' : '0');
+}
+}
+
 VersionFilePtr parseJsonFile(const QFileInfo &fileInfo, const bool requireOrder)
 {
 	QFile file(fileInfo.absoluteFilePath());
@@ -128,10 +180,17 @@ VersionFilePtr parseJsonFile(const QFileInfo &fileInfo, const bool requireOrder)
 		auto errorStr = QObject::tr("Unable to open the version file %1: %2.").arg(fileInfo.fileName(), file.errorString());
 		return createErrorVersionFile(fileInfo.completeBaseName(), fileInfo.absoluteFilePath(), errorStr);
 	}
-	QJsonParseError error;
 	auto data = file.readAll();
-	QJsonDocument doc = QJsonDocument::fromJson(data, &error);
 	file.close();
+
+	auto key = parsedFileKey(data, requireOrder);
+	if (auto cached = parsedFileCache().get(key))
+	{
+		return cached;
+	}
+
+	QJsonParseError error;
+	QJsonDocument doc = QJsonDocument::fromJson(data, &error);
 	if (error.error != QJsonParseError::NoError)
 	{
 		int line = 1;
@@ -151,7 +210,16 @@ VersionFilePtr parseJsonFile(const QFileInfo &fileInfo, const bool requireOrder)
 				.arg(line).arg(column);
 		return createErrorVersionFile(fileInfo.completeBaseName(), fileInfo.absoluteFilePath(), errorStr);
 	}
-	return guardedParseJson(doc, fileInfo.completeBaseName(), fileInfo.absoluteFilePath(), requireOrder);
+	try
+	{
+		auto parsed = OneSixVersionFormat::versionFileFromJson(doc, fileInfo.absoluteFilePath(), requireOrder);
+		parsedFileCache().insert(key, parsed);
+		return parsed;
+	}
+	catch (Exception & e)
+	{
+		return createErrorVersionFile(fileInfo.completeBaseName(), fileInfo.absoluteFilePath(), e.cause());
+	}
 }
 
 VersionFilePtr parseBinaryJsonFile(const QFileInfo &fileInfo)
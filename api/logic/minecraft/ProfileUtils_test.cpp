@@ -0,0 +1,88 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include "TestUtil.h"
+
+#include "minecraft/ProfileUtils.h"
+#include "minecraft/OneSixVersionFormat.h"
+#include "FileSystem.h"
+
+class ProfileUtilsTest : public QObject
+{
+	Q_OBJECT
+private:
+	static QString patchPath()
+	{
+		return QFINDTESTDATA("testdata/1.9.json");
+	}
+	static QByteArray patchData()
+	{
+		return FS::read(patchPath());
+	}
+
+private
+slots:
+	void test_cachedParse()
+	{
+		auto first = ProfileUtils::parseJsonFile(QFileInfo(patchPath()), false);
+		auto second = ProfileUtils::parseJsonFile(QFileInfo(patchPath()), false);
+		QVERIFY(first != second);
+		QCOMPARE(OneSixVersionFormat::versionFileToJson(first, false).toJson(),
+				 OneSixVersionFormat::versionFileToJson(second, false).toJson());
+
+		// what one caller changes does not show up for the next one
+		auto original = first->version;
+		first->version = "changed";
+		first->libraries.clear();
+		auto third = ProfileUtils::parseJsonFile(QFileInfo(patchPath()), false);
+		QCOMPARE(third->version, original);
+		QCOMPARE(third->libraries.size(), second->libraries.size());
+	}
+
+	void test_sharedBetweenFiles()
+	{
+		// identical patches in different instances parse to the same thing
+		QTemporaryDir dir;
+		auto copyPath = FS::PathCombine(dir.path(), "net.minecraft.json");
+		FS::write(copyPath, patchData());
+		auto original = ProfileUtils::parseJsonFile(QFileInfo(patchPath()), false);
+		auto copy = ProfileUtils::parseJsonFile(QFileInfo(copyPath), false);
+		QCOMPARE(OneSixVersionFormat::versionFileToJson(original, false).toJson(),
+				 OneSixVersionFormat::versionFileToJson(copy, false).toJson());
+	}
+
+	void test_changedFile()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "patch.json");
+		FS::write(path, "{\"uid\": \"org.multimc.test\", \"version\": \"1\", \"order\": 5}");
+		auto before = ProfileUtils::parseJsonFile(QFileInfo(path), true);
+		QCOMPARE(before->version, QString("1"));
+		QCOMPARE(before->order, 5);
+
+		FS::write(path, "{\"uid\": \"org.multimc.test\", \"version\": \"2\", \"order\": 5}");
+		auto after = ProfileUtils::parseJsonFile(QFileInfo(path), true);
+		QCOMPARE(after->version, QString("2"));
+
+		// the order is only read when asked for, so it is part of the key
+		auto unordered = ProfileUtils::parseJsonFile(QFileInfo(path), false);
+		QCOMPARE(unordered->order, 0);
+	}
+
+	void test_brokenFile()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "broken.json");
+		FS::write(path, "{\"uid\": ");
+		for(int i = 0; i < 2; i++)
+		{
+			auto broken = ProfileUtils::parseJsonFile(QFileInfo(path), false);
+			QCOMPARE(broken->getProblemSeverity(), ProblemSeverity::Error);
+			QCOMPARE(broken->uid, QString("broken"));
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(ProfileUtilsTest)
+
+#include "ProfileUtils_test.moc"
@@ -17,6 +17,9 @@
 #include <QString>
 #include <QDebug>
 #include <QSaveFile>
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
 #include "World.h"
 
 #include "GZip.h"
@@ -30,6 +33,61 @@
 #include <quazipfile.h>
 #include <quazipdir.h>
 
+namespace {
+// reads straight from a byte array, without copying it into a string first
+class ByteArrayStreamBuf : public std::streambuf
+{
+public:
+	ByteArrayStreamBuf(const QByteArray &data)
+	{
+		auto begin = const_cast<char *>(data.constData());
+		setg(begin, begin, begin + data.size());
+	}
+};
+
+// what the world list shows about a world, remembered until its level.dat changes
+struct LevelSummary
+{
+	QDateTime modified;
+	qint64 size = 0;
+	bool valid = false;
+	QString name;
+	QDateTime lastPlayed;
+	int64_t seed = 0;
+};
+
+class LevelSummaryCache
+{
+public:
+	bool get(const QFileInfo &levelDat, LevelSummary &out)
+	{
+		QMutexLocker locker(&m_lock);
+		auto cached = m_summaries.object(levelDat.absoluteFilePath());
+		if (!cached || cached->modified != levelDat.lastModified() || cached->size != levelDat.size())
+		{
+			return false;
+		}
+		out = *cached;
+		return true;
+	}
+	void insert(const QFileInfo &levelDat, const LevelSummary &summary)
+	{
+		QMutexLocker locker(&m_lock);
+		m_summaries.insert(levelDat.absoluteFilePath(), new LevelSummary(summary));
+	}
+
+private:
+	QMutex m_lock;
+	QCache<QString, LevelSummary> m_summaries {256};
+};
+
+LevelSummaryCache &levelSummaryCache()
+{
+	static LevelSummaryCache cache;
+	return cache;
+}
+}
+
 std::unique_ptr <nbt::tag_compound> parseLevelDat(QByteArray data)
 {
 	QByteArray output;
@@ -37,7 +95,8 @@ std::unique_ptr <nbt::tag_compound> parseLevelDat(QByteArray data)
 	{
 		return nullptr;
 	}
-	std::istringstream foo(std::string(output.constData(), output.size()));
+	ByteArrayStreamBuf buffer(output);
+	std::istream foo(&buffer);
 	auto pair = nbt::io::read_compound(foo);
 
 	if(pair.first != "")
@@ -128,6 +187,23 @@ void World::repath(const QFileInfo &file)
 
 void World::readFromFS(const QFileInfo &file)
 {
+	levelDatTime = file.lastModified();
+	auto levelDatPath = getLevelDatFromFS(file);
+	if(levelDatPath.isNull())
+	{
+		is_valid = false;
+		return;
+	}
+	QFileInfo levelDat(levelDatPath);
+	LevelSummary summary;
+	if(levelSummaryCache().get(levelDat, summary))
+	{
+		is_valid = summary.valid;
+		m_actualName = summary.name;
+		m_lastPlayed = summary.lastPlayed;
+		m_randomSeed = summary.seed;
+		return;
+	}
 	auto bytes = getLevelDatDataFromFS(file);
 	if(bytes.isEmpty())
 	{
@@ -135,7 +211,13 @@ void World::readFromFS(const QFileInfo &file)
 		return;
 	}
 	loadFromLevelDat(bytes);
-	levelDatTime = file.lastModified();
+	summary.modified = levelDat.lastModified();
+	summary.size = levelDat.size();
+	summary.valid = is_valid;
+	summary.name = m_actualName;
+	summary.lastPlayed = m_lastPlayed;
+	summary.seed = m_randomSeed;
+	levelSummaryCache().insert(levelDat, summary);
 }
 
 void World::readFromZip(const QFileInfo &file)
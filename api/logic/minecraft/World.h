@@ -22,6 +22,8 @@
 class MULTIMC_LOGIC_EXPORT World
 {
 public:
+	// an invalid world, for containers that need to make one before filling it in
+	World() = default;
 	World(const QFileInfo &file);
 	QString folderName() const
 	{
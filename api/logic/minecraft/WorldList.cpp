@@ -19,8 +19,17 @@
 #include <QUrl>
 #include <QUuid>
 #include <QString>
-#include <QFileSystemWatcher>
 #include <QDebug>
+#include <QSet>
+#include <QtConcurrentMap>
+
+namespace {
+// runs on worker threads
+World readWorld(const QFileInfo &entry)
+{
+	return World(entry);
+}
+}
 
 WorldList::WorldList(const QString &dir)
 	: QAbstractListModel(), m_dir(dir)
@@ -29,10 +38,12 @@ WorldList::WorldList(const QString &dir)
 	m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs |
 					QDir::NoSymLinks);
 	m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
-	m_watcher = new QFileSystemWatcher(this);
+	m_watcher = new DirectoryWatcher(this);
+	m_watcher->setDirectory(m_dir.absolutePath());
+	// worlds are folders, the files next to them don't matter
+	m_watcher->setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Dirs | QDir::NoSymLinks);
 	is_watching = false;
-	connect(m_watcher, SIGNAL(directoryChanged(QString)), this,
-			SLOT(directoryChanged(QString)));
+	connect(m_watcher, &DirectoryWatcher::changed, this, &WorldList::directoryChanged);
 }
 
 void WorldList::startWatching()
@@ -42,7 +53,7 @@ void WorldList::startWatching()
 		return;
 	}
 	update();
-	is_watching = m_watcher->addPath(m_dir.absolutePath());
+	is_watching = m_watcher->start();
 	if (is_watching)
 	{
 		qDebug() << "Started watching " << m_dir.absolutePath();
@@ -59,15 +70,9 @@ void WorldList::stopWatching()
 	{
 		return;
 	}
-	is_watching = !m_watcher->removePath(m_dir.absolutePath());
-	if (!is_watching)
-	{
-		qDebug() << "Stopped watching " << m_dir.absolutePath();
-	}
-	else
-	{
-		qDebug() << "Failed to stop watching " << m_dir.absolutePath();
-	}
+	m_watcher->stop();
+	is_watching = false;
+	qDebug() << "Stopped watching " << m_dir.absolutePath();
 }
 
 bool WorldList::update()
@@ -75,30 +80,99 @@ bool WorldList::update()
 	if (!isValid())
 		return false;
 
-	QList<World> newWorlds;
+	QList<QFileInfo> entries;
+	QSet<QString> names;
 	m_dir.refresh();
 	auto folderContents = m_dir.entryInfoList();
-	// if there are any untracked files...
 	for (QFileInfo entry : folderContents)
 	{
 		if(!entry.isDir())
 			continue;
-
-		World w(entry);
-		if(w.isValid())
-		{
-			newWorlds.append(w);
-		}
+		entries.append(entry);
+		names.insert(entry.fileName());
+	}
+	// worlds that are gone go away right away, the rest is updated as it is read
+	for (int row = worlds.size() - 1; row >= 0; row--)
+	{
+		if (names.contains(worlds[row].folderName()))
+			continue;
+		beginRemoveRows(QModelIndex(), row, row);
+		worlds.removeAt(row);
+		endRemoveRows();
 	}
-	beginResetModel();
-	worlds.swap(newWorlds);
-	endResetModel();
+	m_generation++;
+	loadWorlds(entries);
 	return true;
 }
 
-void WorldList::directoryChanged(QString path)
+void WorldList::loadWorlds(const QList<QFileInfo> &entries)
 {
-	update();
+	if (entries.isEmpty())
+		return;
+	auto watcher = new QFutureWatcher<World>(this);
+	int generation = m_generation;
+	connect(watcher, &QFutureWatcher<World>::resultReadyAt, this, [this, watcher, generation](int index)
+	{
+		if (generation != m_generation)
+			return;
+		worldLoaded(watcher->resultAt(index));
+	});
+	connect(watcher, &QFutureWatcher<World>::finished, watcher, &QObject::deleteLater);
+	watcher->setFuture(QtConcurrent::mapped(entries, readWorld));
+}
+
+void WorldList::worldLoaded(const World &world)
+{
+	int row = rowOf(world.folderName());
+	if (row >= 0 && world.isValid())
+	{
+		worlds[row] = world;
+		emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+	}
+	else if (row >= 0)
+	{
+		beginRemoveRows(QModelIndex(), row, row);
+		worlds.removeAt(row);
+		endRemoveRows();
+	}
+	// it may have been removed while it was being read
+	else if (world.isValid() && QFileInfo::exists(world.container().absoluteFilePath()))
+	{
+		// the views sort the worlds themselves
+		beginInsertRows(QModelIndex(), worlds.size(), worlds.size());
+		worlds.append(world);
+		endInsertRows();
+	}
+}
+
+void WorldList::directoryChanged(const DirectoryWatcher::Changes &changes)
+{
+	// only the worlds that changed are read again
+	for (auto &name : changes.removed)
+	{
+		int row = rowOf(name);
+		if (row < 0)
+			continue;
+		beginRemoveRows(QModelIndex(), row, row);
+		worlds.removeAt(row);
+		endRemoveRows();
+	}
+	QList<QFileInfo> entries;
+	for (auto &name : changes.changed + changes.added)
+	{
+		entries.append(QFileInfo(m_dir.absoluteFilePath(name)));
+	}
+	loadWorlds(entries);
+}
+
+int WorldList::rowOf(const QString &folderName) const
+{
+	for (int i = 0; i < worlds.size(); i++)
+	{
+		if (worlds[i].folderName() == folderName)
+			return i;
+	}
+	return -1;
 }
 
 bool WorldList::isValid()
@@ -20,12 +20,12 @@
 #include <QDir>
 #include <QAbstractListModel>
 #include <QMimeData>
+#include <QFutureWatcher>
 #include "minecraft/World.h"
+#include "DirectoryWatcher.h"
 
 #include "multimc_logic_export.h"
 
-class QFileSystemWatcher;
-
 class MULTIMC_LOGIC_EXPORT WorldList : public QAbstractListModel
 {
 	Q_OBJECT
@@ -70,7 +70,10 @@ public:
 		return worlds[index];
 	}
 
-	/// Reloads the mod list and returns true if the list changed.
+	/**
+	 * Reloads the world list. Worlds are read in the background and the model is updated as they come in.
+	 * Returns false if the folder can't be read.
+	 */
 	virtual bool update();
 
 	/// Install a world from location
@@ -112,14 +115,21 @@ public:
 	}
 
 private slots:
-	void directoryChanged(QString path);
+	void directoryChanged(const DirectoryWatcher::Changes &changes);
+
+private:
+	int rowOf(const QString &folderName) const;
+	void loadWorlds(const QList<QFileInfo> &entries);
+	void worldLoaded(const World &world);
 
 signals:
 	void changed();
 
 protected:
-	QFileSystemWatcher *m_watcher;
+	DirectoryWatcher *m_watcher;
 	bool is_watching;
 	QDir m_dir;
 	QList<World> worlds;
+	// bumped by every full update, so results of the loads it replaces are dropped
+	int m_generation = 0;
 };
@@ -1,8 +1,86 @@
 #include "FileResolvingTask.h"
 #include "Json.h"
+#include "Env.h"
+#include <QFile>
 
 const char * metabase = "https://cursemeta.dries007.net";
 
+namespace
+{
+bool parseFile(Flame::File &out, const QByteArray &bytes)
+{
+	using Flame::File;
+	try
+	{
+		auto doc = Json::requireDocument(bytes);
+		auto obj = Json::requireObject(doc);
+		// result code signifies true failure.
+		if(obj.contains("code"))
+		{
+			qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of a negative result:";
+			qCritical() << bytes;
+			return false;
+		}
+		out.fileName = Json::requireString(obj, "FileNameOnDisk");
+		out.url = Json::requireString(obj, "DownloadURL");
+		// This is a piece of a Flame project JSON pulled out into the file metadata (here) for convenience
+		// It is also optional
+		QJsonObject projObj = Json::ensureObject(obj, "_Project", {});
+		if(!projObj.isEmpty())
+		{
+			QString strType = Json::ensureString(projObj, "PackageType", "mod").toLower();
+			if(strType == "singlefile")
+			{
+				out.type = File::Type::SingleFile;
+			}
+			// FIXME: what are these?
+			/*
+			else if(strType == "ctoc")
+			{
+				out.type = File::Type::Ctoc;
+			}
+			else if(strType == "cmod2")
+			{
+				out.type = File::Type::Cmod2;
+			}
+			*/
+			else if(strType == "mod")
+			{
+				out.type = File::Type::Mod;
+			}
+			// FIXME: how to handle nested packs and folders?
+			/*
+			else if(strType == "folder")
+			{
+				out.type = File::Type::Folder;
+			}
+			else if(strType == "modpack")
+			{
+				out.type = File::Type::Modpack;
+			}
+			*/
+			else
+			{
+				qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of unknown file type:" << strType;
+				out.type = File::Type::Unknown;
+				return false;
+			}
+			out.targetFolder = Json::ensureString(projObj, "Path", "mods");
+		}
+		out.resolved = true;
+		return true;
+	}
+	catch(JSONValidationError & e)
+	{
+		qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of a parsing error:";
+		qCritical() << e.cause();
+		qCritical() << "JSON:";
+		qCritical() << bytes;
+		return false;
+	}
+}
+}
+
 Flame::FileResolvingTask::FileResolvingTask(Flame::Manifest& toProcess)
 	: m_toProcess(toProcess)
 {
@@ -13,99 +91,64 @@ void Flame::FileResolvingTask::executeTask()
 	setStatus(tr("Resolving mod IDs..."));
 	setProgress(0, m_toProcess.files.size());
 	m_dljob.reset(new NetJob("Mod id resolver"));
-	results.resize(m_toProcess.files.size());
-	int index = 0;
-	for(auto & file: m_toProcess.files)
+	for(int index = 0; index < m_toProcess.files.size(); index++)
 	{
+		auto & file = m_toProcess.files[index];
 		auto projectIdStr = QString::number(file.projectId);
 		auto fileIdStr = QString::number(file.fileId);
+		// the metadata of a file does not change, so once it is in the cache, it does not need to be asked for again
+		auto entry = ENV.metacache()->resolveEntry("general", QString("cursemeta/%1/%2.json").arg(projectIdStr, fileIdStr));
+		if(!entry->isStale())
+		{
+			resolveFromCache(index, entry);
+			continue;
+		}
 		QString metaurl = QString("%1/%2/%3.json").arg(metabase, projectIdStr, fileIdStr);
-		auto dl = Net::Download::makeByteArray(QUrl(metaurl), &results[index]);
+		auto dl = Net::Download::makeCached(QUrl(metaurl), entry);
+		// resolve each file as soon as its metadata arrives, so its download can start right away
+		connect(dl.get(), &NetAction::succeeded, this, [this, index, entry](int)
+		{
+			resolveFromCache(index, entry);
+		});
 		m_dljob->addNetAction(dl);
-		index ++;
 	}
 	connect(m_dljob.get(), &NetJob::finished, this, &Flame::FileResolvingTask::netJobFinished);
 	m_dljob->start();
 }
 
+void Flame::FileResolvingTask::resolveFromCache(int index, MetaEntryPtr entry)
+{
+	auto & out = m_toProcess.files[index];
+	QFile file(entry->getFullPath());
+	if(file.open(QIODevice::ReadOnly) && parseFile(out, file.readAll()))
+	{
+		emit fileResolved(index);
+	}
+	else
+	{
+		// do not keep bad answers around
+		file.close();
+		ENV.metacache()->evictEntry(entry);
+	}
+	setProgress(++m_processed, m_toProcess.files.size());
+}
+
+bool Flame::FileResolvingTask::abort()
+{
+	if(m_dljob)
+	{
+		return m_dljob->abort();
+	}
+	return true;
+}
+
 void Flame::FileResolvingTask::netJobFinished()
 {
+	m_dljob.reset();
 	bool failed = false;
-	int index = 0;
-	for(auto & bytes: results)
+	for(auto & file: m_toProcess.files)
 	{
-		try
-		{
-			auto doc = Json::requireDocument(bytes);
-			auto obj = Json::requireObject(doc);
-			auto & out = m_toProcess.files[index];
-			// result code signifies true failure.
-			if(obj.contains("code"))
-			{
-				qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of a negative result:";
-				qCritical() << bytes;
-				failed = true;
-				continue;
-			}
-			out.fileName = Json::requireString(obj, "FileNameOnDisk");
-			out.url = Json::requireString(obj, "DownloadURL");
-			// This is a piece of a Flame project JSON pulled out into the file metadata (here) for convenience
-			// It is also optional
-			QJsonObject projObj = Json::ensureObject(obj, "_Project", {});
-			if(!projObj.isEmpty())
-			{
-				QString strType = Json::ensureString(projObj, "PackageType", "mod").toLower();
-				if(strType == "singlefile")
-				{
-					out.type = File::Type::SingleFile;
-				}
-				// FIXME: what are these?
-				/*
-				else if(strType == "ctoc")
-				{
-					out.type = File::Type::Ctoc;
-				}
-				else if(strType == "cmod2")
-				{
-					out.type = File::Type::Cmod2;
-				}
-				*/
-				else if(strType == "mod")
-				{
-					out.type = File::Type::Mod;
-				}
-				// FIXME: how to handle nested packs and folders?
-				/*
-				else if(strType == "folder")
-				{
-					out.type = File::Type::Folder;
-				}
-				else if(strType == "modpack")
-				{
-					out.type = File::Type::Modpack;
-				}
-				*/
-				else
-				{
-					qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of unknown file type:" << strType;
-					out.type = File::Type::Unknown;
-					failed = true;
-					continue;
-				}
-				out.targetFolder = Json::ensureString(projObj, "Path", "mods");
-			}
-			out.resolved = true;
-		}
-		catch(JSONValidationError & e)
-		{
-			auto & out = m_toProcess.files[index];
-			qCritical() << "Resolving of" << out.projectId << out.fileId << "failed because of a parsing error:";
-			qCritical() << e.cause();
-			qCritical() << "JSON:";
-			qCritical() << bytes;
-			failed = true;
-		}
-		index++;
+		failed |= !file.resolved;
 	}
 	if(!failed)
 	{
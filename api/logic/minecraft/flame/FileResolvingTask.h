@@ -18,15 +18,30 @@ public:
 		return m_toProcess;
 	}
 
+	bool canAbort() const override
+	{
+		return true;
+	}
+
+signals:
+	/// the file at \p index of the manifest has been resolved and can be downloaded
+	void fileResolved(int index);
+
+public slots:
+	bool abort() override;
+
 protected:
 	virtual void executeTask() override;
 
 protected slots:
 	void netJobFinished();
 
+private:
+	void resolveFromCache(int index, MetaEntryPtr entry);
+
 private: /* data */
 	Flame::Manifest m_toProcess;
-	QVector<QByteArray> results;
 	NetJobPtr m_dljob;
+	int m_processed = 0;
 };
 }
@@ -22,6 +22,12 @@
 #include "MMCZip.h"
 #include "FileSystem.h"
 #include <QDir>
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 
 static QString replaceSuffix (QString target, const QString &suffix, const QString &replacement)
 {
@@ -66,6 +72,86 @@ static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibH
 	return true;
 }
 
+// Describes the native jar without reading it. If this doesn't change, neither does the jar.
+static QString nativesKey(const QString &source)
+{
+	QFileInfo info(source);
+	if (!info.isFile())
+	{
+		return QString();
+	}
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(info.absoluteFilePath().toUtf8() + '\n');
+	hash.addData(QByteArray::number(info.size()) + ' ');
+	hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()) + '\n');
+	return QString::fromLatin1(hash.result().toHex());
+}
+
+/*
+ * Extract the native jar into the shared cache, unless it's already there. Returns the folder with its contents.
+ *
+ * The folders are keyed by the path, size and timestamp of the jar and whether the jnilib hack was applied,
+ * so launches don't hash the jars again. They only ever appear complete: they are extracted to a temporary
+ * folder and moved in place.
+ */
+static QString cacheNatives(const QString &source, const QString &cacheRoot, bool applyJnilibHack)
+{
+	auto key = nativesKey(source);
+	if (key.isEmpty())
+	{
+		return QString();
+	}
+	auto cached = FS::PathCombine(cacheRoot, applyJnilibHack ? key + "-dylib" : key);
+	if (QFileInfo(cached).isDir())
+	{
+		return cached;
+	}
+	if (!FS::ensureFolderPathExists(cacheRoot))
+	{
+		return QString();
+	}
+	QTemporaryDir temp(FS::PathCombine(cacheRoot, "extract-XXXXXX"));
+	if (!temp.isValid() || !unzipNatives(source, temp.path(), applyJnilibHack))
+	{
+		return QString();
+	}
+	if (QDir().rename(temp.path(), cached))
+	{
+		temp.setAutoRemove(false);
+		return cached;
+	}
+	// someone else was faster
+	return QFileInfo(cached).isDir() ? cached : QString();
+}
+
+// put the contents of the cached folder into the natives folder
+static bool linkNatives(const QString &cached, const QString &outputPath)
+{
+	// on Windows, a loaded library can't lose any of its names - the cache would get stuck with it
+#if defined Q_OS_WIN
+	const bool allowHardlink = false;
+#else
+	const bool allowHardlink = true;
+#endif
+	QDir cachedDir(cached);
+	QDirIterator iter(cached, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+	while (iter.hasNext())
+	{
+		auto file = iter.next();
+		auto target = FS::PathCombine(outputPath, cachedDir.relativeFilePath(file));
+		if (FS::cloneFile(file, target, allowHardlink) == FS::CloneMethod::Failed)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+ExtractNatives::ExtractNatives(LaunchTask *parent) : LaunchStep(parent)
+{
+	connect(&m_watcher, &QFutureWatcher<QString>::finished, this, &ExtractNatives::extractFinished);
+}
+
 void ExtractNatives::executeTask()
 {
 	auto instance = m_parent->instance();
@@ -79,14 +165,40 @@ void ExtractNatives::executeTask()
 	auto outputPath  = minecraftInstance->getNativePath();
 	auto javaVersion = minecraftInstance->getJavaVersion();
 	bool jniHackEnabled = javaVersion.major() >= 8;
-	for(const auto &source: toExtract)
+	auto cacheRoot = QDir("cache/natives").absolutePath();
+	auto extract = [toExtract, outputPath, jniHackEnabled, cacheRoot]() -> QString
 	{
-		if(!unzipNatives(source, outputPath, jniHackEnabled))
+		// leftovers of a launch that didn't clean up after itself
+		QDir(outputPath).removeRecursively();
+
+		// the jars are independent of each other, get them into the cache in parallel
+		auto cached = QtConcurrent::blockingMapped<QStringList>(toExtract, std::function<QString(const QString &)>(
+			[cacheRoot, jniHackEnabled](const QString &source)
+			{
+				return cacheNatives(source, cacheRoot, jniHackEnabled);
+			}));
+
+		// later jars win, same as when they were all extracted into one folder
+		for(int i = 0; i < toExtract.size(); i++)
 		{
-			auto reason = tr("Couldn't extract native jar '%1' to destination '%2'").arg(source, outputPath);
-			emit logLine(reason, MessageLevel::Fatal);
-			emitFailed(reason);
+			if(cached[i].isEmpty() || !linkNatives(cached[i], outputPath))
+			{
+				return tr("Couldn't extract native jar '%1' to destination '%2'").arg(toExtract[i], outputPath);
+			}
 		}
+		return QString();
+	};
+	m_watcher.setFuture(QtConcurrent::run(extract));
+}
+
+void ExtractNatives::extractFinished()
+{
+	auto reason = m_watcher.result();
+	if(!reason.isEmpty())
+	{
+		emit logLine(reason, MessageLevel::Fatal);
+		emitFailed(reason);
+		return;
 	}
 	emitSucceeded();
 }
@@ -18,13 +18,18 @@
 #include <launch/LaunchStep.h>
 #include <memory>
 #include "minecraft/auth/AuthSession.h"
+#include <QFutureWatcher>
 
-// FIXME: temporary wrapper for existing task.
+/**
+ * Puts the contents of the native jars into the instance natives folder.
+ *
+ * Each jar is extracted only once, into a shared cache keyed by its contents, and then linked into place.
+ */
 class ExtractNatives: public LaunchStep
 {
 	Q_OBJECT
 public:
-	explicit ExtractNatives(LaunchTask *parent) : LaunchStep(parent){};
+	explicit ExtractNatives(LaunchTask *parent);
 	virtual ~ExtractNatives(){};
 
 	void executeTask() override;
@@ -33,6 +38,12 @@ public:
 		return false;
 	}
 	void finalize() override;
+
+private slots:
+	void extractFinished();
+
+private:
+	QFutureWatcher<QString> m_watcher;
 };
 
 
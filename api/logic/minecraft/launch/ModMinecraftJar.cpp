@@ -21,6 +21,47 @@
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/ComponentList.h"
 
+#include <QCryptographicHash>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QDebug>
+
+// Describes everything the modded jar is built from. If this doesn't change, neither does the jar.
+static QByteArray jarInputsKey(const QString &sourceJarPath, const QList<Mod> &mods)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	auto addFile = [&](const QFileInfo &file)
+	{
+		hash.addData(file.absoluteFilePath().toUtf8());
+		hash.addData(QByteArray::number(file.size()) + ' ');
+		hash.addData(QByteArray::number(file.lastModified().toMSecsSinceEpoch()) + '\n');
+	};
+	hash.addData("1\n");
+	addFile(QFileInfo(sourceJarPath));
+	for (auto &mod : mods)
+	{
+		if (!mod.enabled())
+			continue;
+		hash.addData(QByteArray::number(int(mod.type())) + ' ');
+		addFile(mod.filename());
+		if (mod.type() == Mod::MOD_FOLDER)
+		{
+			QStringList files;
+			QDirIterator iter(mod.filename().absoluteFilePath(), QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+			while (iter.hasNext())
+			{
+				files.append(iter.next());
+			}
+			files.sort();
+			for (auto &file : files)
+			{
+				addFile(QFileInfo(file));
+			}
+		}
+	}
+	return hash.result().toHex();
+}
+
 void ModMinecraftJar::executeTask()
 {
 	auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
@@ -29,8 +70,33 @@ void ModMinecraftJar::executeTask()
 	if(!FS::ensureFolderPathExists(m_inst->binRoot()))
 	{
 		emitFailed(tr("Couldn't create the bin folder for Minecraft.jar"));
+		return;
 	}
 	auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
+	auto keyPath = finalJarPath + ".inputs";
+
+	auto profile = m_inst->getComponentList();
+	auto jarMods = m_inst->getJarMods();
+	QString sourceJarPath;
+	QByteArray key;
+	if(jarMods.size())
+	{
+		auto mainJar = profile->getMainJar();
+		QStringList jars, temp1, temp2, temp3, temp4;
+		mainJar->getApplicableFiles(currentSystem, jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
+		sourceJarPath = jars[0];
+		key = jarInputsKey(sourceJarPath, jarMods);
+
+		// built from the very same things last time, reuse it
+		QFile keyFile(keyPath);
+		if(QFileInfo(finalJarPath).isFile() && keyFile.open(QIODevice::ReadOnly) && keyFile.readAll() == key)
+		{
+			emitSucceeded();
+			return;
+		}
+	}
+
+	QFile::remove(keyPath);
 	QFile finalJar(finalJarPath);
 	if(finalJar.exists())
 	{
@@ -42,19 +108,21 @@ void ModMinecraftJar::executeTask()
 	}
 
 	// create temporary modded jar, if needed
-	auto profile = m_inst->getComponentList();
-	auto jarMods = m_inst->getJarMods();
 	if(jarMods.size())
 	{
-		auto mainJar = profile->getMainJar();
-		QStringList jars, temp1, temp2, temp3, temp4;
-		mainJar->getApplicableFiles(currentSystem, jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
-		auto sourceJarPath = jars[0];
 		if(!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods))
 		{
 			emitFailed(tr("Failed to create the custom Minecraft jar file."));
 			return;
 		}
+		try
+		{
+			FS::write(keyPath, key);
+		}
+		catch (Exception & e)
+		{
+			qWarning() << "Couldn't remember the inputs of the custom Minecraft jar:" << e.what();
+		}
 	}
 	emitSucceeded();
 }
@@ -0,0 +1,85 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ReconstructAssets.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/ComponentList.h"
+#include "minecraft/AssetsUtils.h"
+#include "launch/LaunchTask.h"
+
+#include <QtConcurrentRun>
+
+ReconstructAssets::ReconstructAssets(LaunchTask *parent) : LaunchStep(parent)
+{
+	connect(&m_watcher, &QFutureWatcher<void>::finished, this, &ReconstructAssets::reconstructFinished);
+}
+
+ReconstructAssets::~ReconstructAssets()
+{
+	// the progress goes to this object, do not let the build outlive it
+	m_aborted.storeRelease(1);
+	m_watcher.waitForFinished();
+}
+
+bool ReconstructAssets::abort()
+{
+	m_aborted.storeRelease(1);
+	// otherwise the build ends early and reconstructFinished() takes care of it
+	if(isRunning() && !m_watcher.isRunning())
+	{
+		emitAborted();
+	}
+	return true;
+}
+
+void ReconstructAssets::executeTask()
+{
+	auto instance = m_parent->instance();
+	std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+	auto assets = minecraftInstance->getComponentList()->getMinecraftAssets();
+	m_assetsId = assets->id;
+	// the common case: nothing changed since the last launch
+	if(AssetsUtils::isReconstructed(m_assetsId))
+	{
+		emitSucceeded();
+		return;
+	}
+	setStatus(tr("Preparing assets..."));
+	emit progressReportingRequest();
+}
+
+void ReconstructAssets::proceed()
+{
+	auto assetsId = m_assetsId;
+	auto progress = [this](int done, int total)
+	{
+		reportProgress(done, total);
+	};
+	auto aborted = &m_aborted;
+	m_watcher.setFuture(QtConcurrent::run([assetsId, progress, aborted]()
+	{
+		AssetsUtils::reconstructAssets(assetsId, progress, aborted);
+	}));
+}
+
+void ReconstructAssets::reconstructFinished()
+{
+	if(m_aborted.loadAcquire())
+	{
+		emitAborted();
+		return;
+	}
+	emitSucceeded();
+}
@@ -0,0 +1,48 @@
+/* Copyright 2013-2017 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <launch/LaunchStep.h>
+#include <QFutureWatcher>
+#include <QAtomicInt>
+
+/**
+ * Builds the virtual assets folder used by old versions of the game, if it is out of date.
+ * The work is done on the global thread pool, with the progress reported to the launch.
+ */
+class ReconstructAssets: public LaunchStep
+{
+	Q_OBJECT
+public:
+	explicit ReconstructAssets(LaunchTask *parent);
+	virtual ~ReconstructAssets();
+
+	void executeTask() override;
+	void proceed() override;
+	bool canAbort() const override
+	{
+		return true;
+	}
+	bool abort() override;
+
+private slots:
+	void reconstructFinished();
+
+private:
+	QString m_assetsId;
+	QFutureWatcher<void> m_watcher;
+	QAtomicInt m_aborted;
+};
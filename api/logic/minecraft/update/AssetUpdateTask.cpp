@@ -4,10 +4,22 @@
 #include "minecraft/ComponentList.h"
 #include "net/ChecksumValidator.h"
 #include "minecraft/AssetsUtils.h"
+#include "ContentStore.h"
 
-AssetUpdateTask::AssetUpdateTask(MinecraftInstance * inst)
+#include <QtConcurrentRun>
+
+AssetUpdateTask::AssetUpdateTask(MinecraftInstance * inst, bool verify)
 {
 	m_inst = inst;
+	m_verify = verify;
+	connect(&m_verifyWatcher, &QFutureWatcher<QStringList>::finished, this, &AssetUpdateTask::verifyFinished);
+}
+
+AssetUpdateTask::~AssetUpdateTask()
+{
+	// the verification reports progress to us
+	m_cancelVerify.storeRelease(1);
+	m_verifyWatcher.waitForFinished();
 }
 void AssetUpdateTask::executeTask()
 {
@@ -45,7 +57,6 @@ bool AssetUpdateTask::canAbort() const
 
 void AssetUpdateTask::assetIndexFinished()
 {
-	AssetsIndex index;
 	qDebug() << m_inst->name() << ": Finished asset index download";
 
 	auto profile = m_inst->getComponentList();
@@ -53,15 +64,57 @@ void AssetUpdateTask::assetIndexFinished()
 
 	QString asset_fname = "assets/indexes/" + assets->id + ".json";
 	// FIXME: this looks like a job for a generic validator based on json schema?
-	if (!AssetsUtils::loadAssetsIndexJson(assets->id, asset_fname, &index))
+	if (!AssetsUtils::loadAssetsIndexJson(assets->id, asset_fname, &m_index))
 	{
 		auto metacache = ENV.metacache();
 		auto entry = metacache->resolveEntry("asset_indexes", assets->id + ".json");
 		metacache->evictEntry(entry);
 		emitFailed(tr("Failed to read the assets index!"));
+		return;
 	}
 
-	auto job = index.getDownloadJob();
+	if(m_verify)
+	{
+		setStatus(tr("Verifying assets..."));
+		QStringList hashes;
+		hashes.reserve(m_index.size());
+		for(int i = 0; i < m_index.size(); i++)
+		{
+			hashes.append(m_index.hash(i));
+		}
+		auto progress = [this](int done, int total)
+		{
+			reportProgress(done, total);
+		};
+		auto cancel = &m_cancelVerify;
+		m_verifyWatcher.setFuture(QtConcurrent::run([hashes, progress, cancel]()
+		{
+			return ContentStore("assets/objects").verify(hashes, progress, cancel);
+		}));
+		return;
+	}
+	downloadAssets();
+}
+
+void AssetUpdateTask::verifyFinished()
+{
+	auto bad = m_verifyWatcher.result();
+	if(!bad.isEmpty())
+	{
+		qWarning() << m_inst->name() << ":" << bad.size() << "assets are missing or corrupt";
+		AssetsUtils::invalidateObjects(m_index.id, bad);
+	}
+	if(m_aborted)
+	{
+		emitAborted();
+		return;
+	}
+	downloadAssets();
+}
+
+void AssetUpdateTask::downloadAssets()
+{
+	auto job = m_index.getDownloadJob();
 	if(job)
 	{
 		setStatus(tr("Getting the assets files from Mojang..."));
@@ -88,6 +141,13 @@ void AssetUpdateTask::assetsFailed(QString reason)
 
 bool AssetUpdateTask::abort()
 {
+	if(m_verifyWatcher.isRunning())
+	{
+		// the objects that are left are skipped, we stop once it's done
+		m_aborted = true;
+		m_cancelVerify.storeRelease(1);
+		return true;
+	}
 	if(downloadJob)
 	{
 		return downloadJob->abort();
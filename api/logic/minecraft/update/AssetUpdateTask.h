@@ -1,13 +1,17 @@
 #pragma once
 #include "tasks/Task.h"
 #include "net/NetJob.h"
+#include "minecraft/AssetsUtils.h"
+#include <QFutureWatcher>
 class MinecraftInstance;
 
 class AssetUpdateTask : public Task
 {
 	Q_OBJECT
 public:
-	AssetUpdateTask(MinecraftInstance * inst);
+	/// With verify set, the objects already present are also checked against their hashes.
+	AssetUpdateTask(MinecraftInstance * inst, bool verify = false);
+	virtual ~AssetUpdateTask();
 	void executeTask() override;
 
 	bool canAbort() const override;
@@ -16,11 +20,20 @@ private slots:
 	void assetIndexFinished();
 	void assetIndexFailed(QString reason);
 	void assetsFailed(QString reason);
+	void verifyFinished();
 
 public slots:
 	bool abort() override;
 
+private:
+	void downloadAssets();
+
 private:
 	MinecraftInstance *m_inst;
 	NetJobPtr downloadJob;
+	bool m_verify = false;
+	bool m_aborted = false;
+	QAtomicInt m_cancelVerify;
+	AssetsIndex m_index;
+	QFutureWatcher<QStringList> m_verifyWatcher;
 };
@@ -101,7 +101,8 @@ void FMLLibrariesTask::fmllibsFinished()
 				emitFailed(tr("Failed creating FML library folder inside the instance."));
 				return;
 			}
-			if (!QFile::copy(entry->getFullPath(), FS::PathCombine(inst->libDir(), lib.filename)))
+			// no hard link: the cache entry would change along with the instance's copy
+			if (FS::cloneFile(entry->getFullPath(), path, false) == FS::CloneMethod::Failed)
 			{
 				emitFailed(tr("Failed copying Forge/FML library: %1.").arg(lib.filename));
 				return;
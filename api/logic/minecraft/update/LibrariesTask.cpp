@@ -6,11 +6,12 @@
 LibrariesTask::LibrariesTask(MinecraftInstance * inst)
 {
 	m_inst = inst;
+	connect(&m_resolveWatcher, &QFutureWatcher<MetaEntryPtr>::finished, this, &LibrariesTask::entriesResolved);
 }
 
 void LibrariesTask::executeTask()
 {
-	setStatus(tr("Getting the library files from Mojang..."));
+	setStatus(tr("Checking the library files..."));
 	qDebug() << m_inst->name() << ": downloading libraries";
 	MinecraftInstance *inst = (MinecraftInstance *)m_inst;
 	inst->reloadProfile();
@@ -20,7 +21,39 @@ void LibrariesTask::executeTask()
 		return;
 	}
 
+	// Check the cached library files on the thread pool first. Changed files are hashed there in parallel,
+	// so building the download list afterwards only needs to look at timestamps.
+	std::shared_ptr<ComponentList> profile = inst->getComponentList();
+	QStringList paths;
+	auto addPaths = [&](const QList<LibraryPtr> & libs)
+	{
+		for (auto lib : libs)
+		{
+			if(lib)
+			{
+				paths.append(lib->getCachePaths(currentSystem));
+			}
+		}
+	};
+	addPaths(profile->getLibraries());
+	addPaths(profile->getNativeLibraries());
+	addPaths(profile->getJarMods());
+	addPaths({profile->getMainJar()});
+
+	m_resolveWatcher.setFuture(ENV.metacache()->resolveEntries("libraries", paths));
+}
+
+void LibrariesTask::entriesResolved()
+{
+	if (m_resolveWatcher.isCanceled())
+	{
+		emitAborted();
+		return;
+	}
+
 	// Build a list of URLs that will need to be downloaded.
+	setStatus(tr("Getting the library files from Mojang..."));
+	MinecraftInstance *inst = (MinecraftInstance *)m_inst;
 	std::shared_ptr<ComponentList> profile = inst->getComponentList();
 
 	auto job = new NetJob(tr("Libraries for instance %1").arg(inst->name()));
@@ -87,6 +120,11 @@ bool LibrariesTask::abort()
 	{
 		return downloadJob->abort();
 	}
+	else if(m_resolveWatcher.isRunning())
+	{
+		m_resolveWatcher.cancel();
+		return true;
+	}
 	else
 	{
 		qWarning() << "Prematurely aborted LibrariesTask";
@@ -1,6 +1,8 @@
 #pragma once
 #include "tasks/Task.h"
 #include "net/NetJob.h"
+#include "net/HttpMetaCache.h"
+#include <QFutureWatcher>
 class MinecraftInstance;
 
 class LibrariesTask : public Task
@@ -14,6 +16,7 @@ public:
 	bool canAbort() const override;
 
 private slots:
+	void entriesResolved();
 	void jarlibFailed(QString reason);
 
 public slots:
@@ -22,4 +25,5 @@ public slots:
 private:
 	MinecraftInstance *m_inst;
 	NetJobPtr downloadJob;
+	QFutureWatcher<MetaEntryPtr> m_resolveWatcher;
 };
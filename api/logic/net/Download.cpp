@@ -17,6 +17,7 @@
 
 #include <QFileInfo>
 #include <QDateTime>
+#include <QHash>
 #include <QDebug>
 #include "Env.h"
 #include <FileSystem.h>
@@ -26,6 +27,21 @@
 
 namespace Net {
 
+/*
+ * Downloads that are currently writing to a file, by absolute target path.
+ * Shared by all NetJobs, so two jobs never fetch and write the same file at the same time.
+ */
+static QHash<QString, QPointer<Download>> & runningDownloads()
+{
+	static QHash<QString, QPointer<Download>> downloads;
+	return downloads;
+}
+
+static QString targetKey(const QString & path)
+{
+	return QFileInfo(path).absoluteFilePath();
+}
+
 Download::Download():NetAction()
 {
 	m_status = Job_NotStarted;
@@ -58,6 +74,7 @@ Download::Ptr Download::makeFile(QUrl url, QString path, Options options)
 	dl->m_url = url;
 	dl->m_options = options;
 	dl->m_sink.reset(new FileSink(path));
+	dl->m_target_path = path;
 	return std::shared_ptr<Download>(dl);
 }
 
@@ -74,6 +91,15 @@ void Download::start()
 		emit aborted(m_index_within_job);
 		return;
 	}
+	if(!m_target_path.isEmpty())
+	{
+		auto running = runningDownloads().value(targetKey(m_target_path));
+		if(running && running != this)
+		{
+			attachTo(running);
+			return;
+		}
+	}
 	QNetworkRequest request(m_url);
 	m_status = m_sink->init(request);
 	switch(m_status)
@@ -84,6 +110,10 @@ void Download::start()
 			return;
 		case Job_InProgress:
 			qDebug() << "Downloading " << m_url.toString();
+			if(!m_target_path.isEmpty())
+			{
+				runningDownloads().insert(targetKey(m_target_path), this);
+			}
 			break;
 		case Job_Failed_Proceed: // this is meaningless in this context. We do need a sink.
 		case Job_NotStarted:
@@ -106,6 +136,65 @@ void Download::start()
 	connect(rep, &QNetworkReply::readyRead, this, &Download::downloadReadyRead);
 }
 
+void Download::attachTo(Download * other)
+{
+	qDebug() << "Download of" << m_target_path << "is already running, waiting for it:" << m_url.toString();
+	m_attachedTo = other;
+	m_status = Job_InProgress;
+	// only report the progress. It's not ours, so it isn't counted as ours.
+	connect(other, &NetAction::netActionProgress, this, [this](int, qint64 current, qint64 total)
+	{
+		emit netActionProgress(m_index_within_job, current, total);
+	});
+	connect(other, &NetAction::succeeded, this, [this]()
+	{
+		bool reallyDownloaded = m_attachedTo && m_attachedTo->m_status == Job_Finished;
+		detach();
+		if(!reallyDownloaded)
+		{
+			// the other download only accepted local data. We might not, so try for ourselves.
+			start();
+			return;
+		}
+		m_status = Job_Finished;
+		qDebug() << "Download succeeded through another download:" << m_url.toString();
+		emit succeeded(m_index_within_job);
+	});
+	auto retry = [this]()
+	{
+		// the other download didn't make it. Maybe we will.
+		detach();
+		start();
+	};
+	connect(other, &NetAction::failed, this, retry);
+	connect(other, &NetAction::aborted, this, retry);
+	// the other download is gone without finishing (its job was destroyed)
+	connect(other, &QObject::destroyed, this, retry);
+}
+
+void Download::detach()
+{
+	if(m_attachedTo)
+	{
+		m_attachedTo->disconnect(this);
+	}
+	m_attachedTo.clear();
+	m_status = Job_NotStarted;
+}
+
+void Download::unregisterTarget()
+{
+	if(m_target_path.isEmpty())
+	{
+		return;
+	}
+	auto key = targetKey(m_target_path);
+	if(runningDownloads().value(key) == this)
+	{
+		runningDownloads().remove(key);
+	}
+}
+
 void Download::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 {
 	m_total_progress = bytesTotal;
@@ -185,6 +274,9 @@ void Download::downloadFinished()
 		return;
 	}
 
+	// from here on, others have to do the download themselves if this one doesn't succeed
+	unregisterTarget();
+
 	// if the download failed before this point ...
 	if (m_status == Job_Failed_Proceed)
 	{
@@ -254,8 +346,20 @@ void Download::downloadReadyRead()
 
 }
 
+Net::Download::~Download()
+{
+	unregisterTarget();
+}
+
 bool Net::Download::abort()
 {
+	if(m_attachedTo)
+	{
+		detach();
+		m_status = Job_Aborted;
+		emit aborted(m_index_within_job);
+		return true;
+	}
 	if(m_reply)
 	{
 		m_reply->abort();
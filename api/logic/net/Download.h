@@ -20,6 +20,8 @@
 #include "Validator.h"
 #include "Sink.h"
 
+#include <QPointer>
+
 #include "multimc_logic_export.h"
 namespace Net {
 class MULTIMC_LOGIC_EXPORT Download : public NetAction
@@ -38,7 +40,7 @@ public: /* types */
 protected: /* con/des */
 	explicit Download();
 public:
-	virtual ~Download(){};
+	virtual ~Download();
 	static Download::Ptr makeCached(QUrl url, MetaEntryPtr entry, Options options = Option::NoOptions);
 	static Download::Ptr makeByteArray(QUrl url, QByteArray *output, Options options = Option::NoOptions);
 	static Download::Ptr makeFile(QUrl url, QString path, Options options = Option::NoOptions);
@@ -54,6 +56,11 @@ public: /* methods */
 
 private: /* methods */
 	bool handleRedirect();
+	/// wait for another running download of the same target, instead of downloading it again
+	void attachTo(Download * other);
+	void detach();
+	/// the target is no longer being written to by this download
+	void unregisterTarget();
 
 protected slots:
 	void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) override;
@@ -70,6 +77,8 @@ private: /* data */
 	QString m_target_path;
 	std::unique_ptr<Sink> m_sink;
 	Options m_options;
+	/// the download we are waiting for, if any
+	QPointer<Download> m_attachedTo;
 };
 }
 
@@ -0,0 +1,149 @@
+#include "HostScheduler.h"
+
+#include <QDebug>
+
+namespace Net {
+
+namespace
+{
+// requests smaller than this are used to measure latency
+const qint64 smallRequestBytes = 64 * 1024;
+// shortest measurement window worth drawing conclusions from
+const qint64 minWindowMsecs = 250;
+}
+
+HostScheduler::HostScheduler() : QObject()
+{
+}
+
+void HostScheduler::setLimits(int minPerHost, int maxPerHost, int maxTotal)
+{
+	m_minPerHost = qMax(1, minPerHost);
+	m_maxPerHost = qMax(m_minPerHost, maxPerHost);
+	m_maxTotal = qMax(1, maxTotal);
+	m_initialPerHost = qBound(m_minPerHost, 6, m_maxPerHost);
+	for (auto &state : m_hosts)
+	{
+		state.limit = qBound(m_minPerHost, state.limit, m_maxPerHost);
+	}
+	emit slotsAvailable();
+}
+
+bool HostScheduler::tryAcquire(const QString &host)
+{
+	if (m_active >= m_maxTotal)
+	{
+		return false;
+	}
+	auto &state = m_hosts[host];
+	if (state.limit == 0)
+	{
+		state.limit = m_initialPerHost;
+	}
+	if (state.active >= state.limit)
+	{
+		return false;
+	}
+	if (!state.window.isValid())
+	{
+		state.window.start();
+	}
+	state.active++;
+	m_active++;
+	return true;
+}
+
+void HostScheduler::release(const QString &host, Outcome outcome, qint64 bytes, qint64 msecs)
+{
+	auto iter = m_hosts.find(host);
+	if (iter == m_hosts.end() || iter->active == 0)
+	{
+		qWarning() << "Released a download slot that was never acquired for host" << host;
+		return;
+	}
+	auto &state = *iter;
+	state.active--;
+	m_active--;
+
+	switch (outcome)
+	{
+		case Outcome::Failed:
+		{
+			// back off hard, the host (or the network) is struggling
+			state.limit = qMax(m_minPerHost, state.limit / 2);
+			state.window.restart();
+			state.windowBytes = 0;
+			state.windowCompletions = 0;
+			state.lastThroughput = 0.0;
+			break;
+		}
+		case Outcome::Succeeded:
+		{
+			// cache hits and such didn't really go over the network
+			if (bytes <= 0)
+			{
+				break;
+			}
+			state.windowBytes += bytes;
+			state.windowCompletions++;
+			if (bytes < smallRequestBytes)
+			{
+				state.latency = state.latency == 0.0 ? msecs : state.latency * 0.8 + msecs * 0.2;
+				if (state.bestLatency == 0.0 || state.latency < state.bestLatency)
+				{
+					state.bestLatency = state.latency;
+				}
+			}
+			adapt(host, state);
+			break;
+		}
+		case Outcome::Aborted:
+			break;
+	}
+	QMetaObject::invokeMethod(this, "slotsAvailable", Qt::QueuedConnection);
+}
+
+void HostScheduler::adapt(const QString &host, HostState &state)
+{
+	// wait for a full round of requests at the current limit
+	if (state.windowCompletions < state.limit)
+	{
+		return;
+	}
+	qint64 elapsed = state.window.elapsed();
+	if (elapsed < minWindowMsecs)
+	{
+		return;
+	}
+	double throughput = double(state.windowBytes) / elapsed;
+	bool latencyOk = state.bestLatency == 0.0 || state.latency < state.bestLatency * 3.0;
+	int oldLimit = state.limit;
+	if (!latencyOk || throughput < state.lastThroughput * 0.8)
+	{
+		state.limit = qMax(m_minPerHost, state.limit - 1);
+	}
+	else if (throughput > state.lastThroughput * 1.05)
+	{
+		state.limit = qMin(m_maxPerHost, state.limit + 1);
+	}
+	if (oldLimit != state.limit)
+	{
+		qDebug() << "Download limit for" << host << "changed from" << oldLimit << "to" << state.limit
+				 << "at" << int(throughput) << "kB/s";
+	}
+	state.lastThroughput = throughput;
+	state.windowBytes = 0;
+	state.windowCompletions = 0;
+	state.window.restart();
+}
+
+int HostScheduler::limit(const QString &host) const
+{
+	auto iter = m_hosts.find(host);
+	if (iter == m_hosts.end() || iter->limit == 0)
+	{
+		return m_initialPerHost;
+	}
+	return iter->limit;
+}
+}
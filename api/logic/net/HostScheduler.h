@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QElapsedTimer>
+
+#include "multimc_logic_export.h"
+
+namespace Net {
+/**
+ * Process-wide limits on how many downloads can run at once, per host and in total.
+ *
+ * The limit of each host adapts to the throughput and latency measured for it:
+ * it grows while adding requests still makes things faster and shrinks when it stops helping,
+ * latency climbs or requests start failing.
+ *
+ * QNetworkAccessManager keeps up to 6 keep-alive connections per host. Limits above that keep
+ * its request queue full, so the connections go straight to the next request.
+ */
+class MULTIMC_LOGIC_EXPORT HostScheduler : public QObject
+{
+	Q_OBJECT
+public: /* types */
+	enum class Outcome
+	{
+		Succeeded,
+		Failed,
+		Aborted
+	};
+
+public: /* methods */
+	HostScheduler();
+
+	void setLimits(int minPerHost, int maxPerHost, int maxTotal);
+
+	/// Try to take a download slot for the host. Every taken slot has to be given back with release()
+	bool tryAcquire(const QString &host);
+
+	/// Give back a slot, along with what was measured while using it
+	void release(const QString &host, Outcome outcome, qint64 bytes, qint64 msecs);
+
+	/// Current concurrency limit for the host
+	int limit(const QString &host) const;
+
+signals:
+	/// Emitted (queued) when slots were released
+	void slotsAvailable();
+
+private: /* types */
+	struct HostState
+	{
+		int active = 0;
+		int limit = 0;
+		// measurement window
+		QElapsedTimer window;
+		qint64 windowBytes = 0;
+		int windowCompletions = 0;
+		double lastThroughput = 0.0;
+		// latency of small requests, in msecs
+		double latency = 0.0;
+		double bestLatency = 0.0;
+	};
+
+private: /* methods */
+	void adapt(const QString &host, HostState &state);
+
+private: /* data */
+	QMap<QString, HostState> m_hosts;
+	int m_active = 0;
+	int m_minPerHost = 2;
+	int m_initialPerHost = 6;
+	int m_maxPerHost = 24;
+	int m_maxTotal = 48;
+};
+}
@@ -21,6 +21,9 @@
 #include <QFile>
 #include <QDateTime>
 #include <QCryptographicHash>
+#include <QtEndian>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include <QDebug>
 
@@ -28,15 +31,127 @@
 #include <QJsonArray>
 #include <QJsonObject>
 
+/*
+ * Binary index format, all numbers are little endian:
+ *
+ * header:       8 bytes magic "MMCMETA\0", quint32 version, quint32 reserved
+ * then any number of records:
+ *   string:     quint32 'S', quint32 length, UTF-8 bytes padded to a multiple of 4
+ *               strings get sequential ids starting at 1, 0 is the empty string
+ *   entry:      quint32 'E', quint32 base, quint32 path, quint32 etag, quint32 remote timestamp,
+ *               quint32 flags, qint64 local timestamp, 16 bytes md5
+ *   tombstone:  same as entry, with tag 'D'. Removes the entry for base/path.
+ *
+ * Later records for the same base/path replace earlier ones.
+ */
+namespace
+{
+const char indexMagic[8] = {'M', 'M', 'C', 'M', 'E', 'T', 'A', '\0'};
+const quint32 indexVersion = 1;
+const int headerSize = 16;
+const quint32 tagString = 'S';
+const quint32 tagEntry = 'E';
+const quint32 tagTombstone = 'D';
+const int entryRecordSize = 48;
+const quint32 flagHasMD5 = 1;
+
+// compact when there are this many more records than live entries
+const int compactionSlack = 4096;
+
+struct EntryRecord
+{
+	quint32 tag = tagEntry;
+	quint32 base = 0;
+	quint32 path = 0;
+	quint32 etag = 0;
+	quint32 remoteTimestamp = 0;
+	quint32 flags = 0;
+	qint64 localTimestamp = 0;
+	QByteArray md5;
+};
+
+void writeHeader(QByteArray &out)
+{
+	out.append(indexMagic, sizeof(indexMagic));
+	uchar buf[8];
+	qToLittleEndian<quint32>(indexVersion, buf);
+	qToLittleEndian<quint32>(0, buf + 4);
+	out.append((const char *)buf, 8);
+}
+
+void writeString(QByteArray &out, const QString &string)
+{
+	QByteArray utf8 = string.toUtf8();
+	uchar buf[8];
+	qToLittleEndian<quint32>(tagString, buf);
+	qToLittleEndian<quint32>(utf8.size(), buf + 4);
+	out.append((const char *)buf, 8);
+	out.append(utf8);
+	int padding = (4 - utf8.size() % 4) % 4;
+	out.append(padding, '\0');
+}
+
+void writeEntry(QByteArray &out, const EntryRecord &record)
+{
+	uchar buf[entryRecordSize];
+	qToLittleEndian<quint32>(record.tag, buf);
+	qToLittleEndian<quint32>(record.base, buf + 4);
+	qToLittleEndian<quint32>(record.path, buf + 8);
+	qToLittleEndian<quint32>(record.etag, buf + 12);
+	qToLittleEndian<quint32>(record.remoteTimestamp, buf + 16);
+	qToLittleEndian<quint32>(record.flags, buf + 20);
+	qToLittleEndian<qint64>(record.localTimestamp, buf + 24);
+	memset(buf + 32, 0, 16);
+	if (record.flags & flagHasMD5)
+	{
+		memcpy(buf + 32, record.md5.constData(), 16);
+	}
+	out.append((const char *)buf, entryRecordSize);
+}
+
+void setEntryData(EntryRecord &record, qint64 localTimestamp, const QString &md5sum)
+{
+	record.tag = tagEntry;
+	record.localTimestamp = localTimestamp;
+	record.md5 = QByteArray::fromHex(md5sum.toLatin1());
+	if (record.md5.size() == 16)
+	{
+		record.flags |= flagHasMD5;
+	}
+}
+
+EntryRecord readEntry(const uchar *data)
+{
+	EntryRecord record;
+	record.tag = qFromLittleEndian<quint32>(data);
+	record.base = qFromLittleEndian<quint32>(data + 4);
+	record.path = qFromLittleEndian<quint32>(data + 8);
+	record.etag = qFromLittleEndian<quint32>(data + 12);
+	record.remoteTimestamp = qFromLittleEndian<quint32>(data + 16);
+	record.flags = qFromLittleEndian<quint32>(data + 20);
+	record.localTimestamp = qFromLittleEndian<qint64>(data + 24);
+	if (record.flags & flagHasMD5)
+	{
+		record.md5 = QByteArray((const char *)data + 32, 16);
+	}
+	return record;
+}
+}
+
 QString MetaEntry::getFullPath()
 {
 	// FIXME: make local?
 	return FS::PathCombine(basePath, relativePath);
 }
 
-HttpMetaCache::HttpMetaCache(QString path) : QObject()
+HttpMetaCache::HttpMetaCache(QString path) : QObject(), m_lock(QMutex::Recursive)
 {
 	m_index_file = path;
+	if (!path.isNull())
+	{
+		m_binary_index_file = path + ".bin";
+	}
+	m_strings.append(QString());
 	saveBatchingTimer.setSingleShot(true);
 	saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
 	connect(&saveBatchingTimer, SIGNAL(timeout()), SLOT(SaveNow()));
@@ -50,6 +165,7 @@ HttpMetaCache::~HttpMetaCache()
 
 MetaEntryPtr HttpMetaCache::getEntry(QString base, QString resource_path)
 {
+	QMutexLocker locker(&m_lock);
 	// no base. no base path. can't store
 	if (!m_entries.contains(base))
 	{
@@ -66,6 +182,7 @@ MetaEntryPtr HttpMetaCache::getEntry(QString base, QString resource_path)
 
 MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag)
 {
+	QMutexLocker locker(&m_lock);
 	auto entry = getEntry(base, resource_path);
 	// it's not present? generate a default stale entry
 	if (!entry)
@@ -73,41 +190,52 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path, QS
 		return staleEntry(base, resource_path);
 	}
 
-	auto &selected_base = m_entries[base];
-	QString real_path = FS::PathCombine(selected_base.base_path, resource_path);
-	QFileInfo finfo(real_path);
+	QString real_path = FS::PathCombine(m_entries[base].base_path, resource_path);
+	QString known_md5sum = entry->md5sum;
+	qint64 known_last_changed = entry->local_changed_timestamp;
+	bool valid = expected_etag.isEmpty() || expected_etag == entry->etag;
+
+	// look at the file without holding the lock, so other threads can do the same
+	locker.unlock();
 
 	// is the file really there? if not -> stale
-	if (!finfo.isFile() || !finfo.isReadable())
+	QFileInfo finfo(real_path);
+	valid = valid && finfo.isFile() && finfo.isReadable();
+
+	// if the file changed, check md5sum
+	qint64 file_last_changed = 0;
+	bool changed = false;
+	if (valid)
 	{
-		// if the file doesn't exist, we disown the entry
-		selected_base.entry_list.remove(resource_path);
-		return staleEntry(base, resource_path);
+		file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
+		changed = file_last_changed != known_last_changed;
+		if (changed)
+		{
+			valid = QString::fromLatin1(FS::hashFile(real_path, QCryptographicHash::Md5).toHex()) == known_md5sum;
+		}
 	}
 
-	if (!expected_etag.isEmpty() && expected_etag != entry->etag)
+	locker.relock();
+	// the entry was replaced or removed while we were looking. start over.
+	if (getEntry(base, resource_path) != entry)
 	{
-		// if the etag doesn't match expected, we disown the entry
-		selected_base.entry_list.remove(resource_path);
+		locker.unlock();
+		return resolveEntry(base, resource_path, expected_etag);
+	}
+
+	if (!valid)
+	{
+		// if the file doesn't exist, the etag doesn't match or the contents changed, we disown the entry
+		m_entries[base].entry_list.remove(resource_path);
+		markDirty(base, resource_path);
 		return staleEntry(base, resource_path);
 	}
 
-	// if the file changed, check md5sum
-	qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
-	if (file_last_changed != entry->local_changed_timestamp)
-	{
-		QFile input(real_path);
-		input.open(QIODevice::ReadOnly);
-		QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5)
-							 .toHex()
-							 .constData();
-		if (entry->md5sum != md5sum)
-		{
-			selected_base.entry_list.remove(resource_path);
-			return staleEntry(base, resource_path);
-		}
+	if (changed)
+	{
 		// md5sums matched... keep entry and save the new state to file
 		entry->local_changed_timestamp = file_last_changed;
+		markDirty(base, resource_path);
 		SaveEventually();
 	}
 
@@ -116,8 +244,18 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path, QS
 	return entry;
 }
 
+QFuture<MetaEntryPtr> HttpMetaCache::resolveEntries(QString base, QStringList resource_paths)
+{
+	std::function<MetaEntryPtr(const QString &)> resolve = [this, base](const QString &resource_path)
+	{
+		return resolveEntry(base, resource_path);
+	};
+	return QtConcurrent::mapped(resource_paths, resolve);
+}
+
 bool HttpMetaCache::updateEntry(MetaEntryPtr stale_entry)
 {
+	QMutexLocker locker(&m_lock);
 	if (!m_entries.contains(stale_entry->baseId))
 	{
 		qCritical() << "Cannot add entry with unknown base: "
@@ -130,6 +268,7 @@ bool HttpMetaCache::updateEntry(MetaEntryPtr stale_entry)
 		return false;
 	}
 	m_entries[stale_entry->baseId].entry_list[stale_entry->relativePath] = stale_entry;
+	markDirty(stale_entry->baseId, stale_entry->relativePath);
 	SaveEventually();
 	return true;
 }
@@ -138,7 +277,9 @@ bool HttpMetaCache::evictEntry(MetaEntryPtr entry)
 {
 	if(entry)
 	{
+		QMutexLocker locker(&m_lock);
 		entry->stale = true;
+		markDirty(entry->baseId, entry->relativePath);
 		SaveEventually();
 		return true;
 	}
@@ -157,6 +298,7 @@ MetaEntryPtr HttpMetaCache::staleEntry(QString base, QString resource_path)
 
 void HttpMetaCache::addBase(QString base, QString base_root)
 {
+	QMutexLocker locker(&m_lock);
 	// TODO: report error
 	if (m_entries.contains(base))
 		return;
@@ -168,6 +310,7 @@ void HttpMetaCache::addBase(QString base, QString base_root)
 
 QString HttpMetaCache::getBasePath(QString base)
 {
+	QMutexLocker locker(&m_lock);
 	if (m_entries.contains(base))
 	{
 		return m_entries[base].base_path;
@@ -175,35 +318,157 @@ QString HttpMetaCache::getBasePath(QString base)
 	return QString();
 }
 
+void HttpMetaCache::markDirty(const QString &base, const QString &resource_path)
+{
+	m_dirty[base].insert(resource_path);
+}
+
 void HttpMetaCache::Load()
 {
 	if(m_index_file.isNull())
 		return;
 
+	QMutexLocker locker(&m_lock);
+	if (loadBinary())
+		return;
+
+	// no usable binary index. import the old JSON one and convert it.
+	if (loadJson())
+	{
+		qDebug() << "Converting" << m_index_file << "to" << m_binary_index_file;
+		compactBinary();
+	}
+}
+
+bool HttpMetaCache::loadBinary()
+{
+	QFile index(m_binary_index_file);
+	if (!index.open(QIODevice::ReadOnly))
+		return false;
+
+	qint64 size = index.size();
+	if (size < headerSize)
+		return false;
+
+	QByteArray fallback;
+	const uchar *data = index.map(0, size);
+	if (!data)
+	{
+		fallback = index.readAll();
+		if (fallback.size() != size)
+			return false;
+		data = (const uchar *)fallback.constData();
+	}
+
+	if (memcmp(data, indexMagic, sizeof(indexMagic)) != 0)
+		return false;
+	if (qFromLittleEndian<quint32>(data + 8) != indexVersion)
+		return false;
+
+	QVector<QString> strings;
+	strings.append(QString());
+	int records = 0;
+	qint64 offset = headerSize;
+	while (offset + 8 <= size)
+	{
+		quint32 tag = qFromLittleEndian<quint32>(data + offset);
+		if (tag == tagString)
+		{
+			qint64 length = qFromLittleEndian<quint32>(data + offset + 4);
+			qint64 padded = (length + 3) / 4 * 4;
+			if (offset + 8 + padded > size)
+				break;
+			strings.append(QString::fromUtf8((const char *)data + offset + 8, int(length)));
+			offset += 8 + padded;
+		}
+		else if (tag == tagEntry || tag == tagTombstone)
+		{
+			if (offset + entryRecordSize > size)
+				break;
+			auto record = readEntry(data + offset);
+			if (record.base >= uint(strings.size()) || record.path >= uint(strings.size()) ||
+				record.etag >= uint(strings.size()) ||
+				record.remoteTimestamp >= uint(strings.size()))
+			{
+				qWarning() << "Metacache index" << m_binary_index_file << "references unknown strings, ignoring the rest.";
+				break;
+			}
+			offset += entryRecordSize;
+			records++;
+
+			const QString &base = strings[record.base];
+			const QString &path = strings[record.path];
+			if (!m_entries.contains(base))
+				continue;
+			auto &entrymap = m_entries[base];
+			if (tag == tagTombstone)
+			{
+				entrymap.entry_list.remove(path);
+				continue;
+			}
+			auto foo = new MetaEntry();
+			foo->baseId = base;
+			foo->relativePath = path;
+			if (record.flags & flagHasMD5)
+			{
+				foo->md5sum = QString::fromLatin1(record.md5.toHex());
+			}
+			foo->etag = strings[record.etag];
+			foo->local_changed_timestamp = record.localTimestamp;
+			foo->remote_changed_timestamp = strings[record.remoteTimestamp];
+			// presumed innocent until closer examination
+			foo->stale = false;
+			entrymap.entry_list[path] = MetaEntryPtr(foo);
+		}
+		else
+		{
+			qWarning() << "Metacache index" << m_binary_index_file << "contains an unknown record, ignoring the rest.";
+			break;
+		}
+	}
+	if (offset != size)
+	{
+		qWarning() << "Metacache index" << m_binary_index_file << "is truncated or damaged at offset" << offset;
+	}
+
+	// anything after the last good record gets overwritten by the next append
+	m_binary_size = offset;
+	m_records = records;
+	m_strings = strings;
+	m_string_ids.clear();
+	for (int i = 1; i < m_strings.size(); i++)
+	{
+		m_string_ids.insert(m_strings[i], quint32(i));
+	}
+	return true;
+}
+
+bool HttpMetaCache::loadJson()
+{
 	QFile index(m_index_file);
 	if (!index.open(QIODevice::ReadOnly))
-		return;
+		return false;
 
 	QJsonDocument json = QJsonDocument::fromJson(index.readAll());
 	if (!json.isObject())
-		return;
+		return false;
 	auto root = json.object();
 	// check file version first
 	auto version_val = root.value("version");
 	if (!version_val.isString())
-		return;
+		return false;
 	if (version_val.toString() != "1")
-		return;
+		return false;
 
 	// read the entry array
 	auto entries_val = root.value("entries");
 	if (!entries_val.isArray())
-		return;
+		return false;
 	QJsonArray array = entries_val.toArray();
 	for (auto element : array)
 	{
 		if (!element.isObject())
-			return;
+			return true;
 		auto element_obj = element.toObject();
 		QString base = element_obj.value("base").toString();
 		if (!m_entries.contains(base))
@@ -221,53 +486,172 @@ void HttpMetaCache::Load()
 		foo->stale = false;
 		entrymap.entry_list[path] = MetaEntryPtr(foo);
 	}
+	return true;
 }
 
-void HttpMetaCache::SaveEventually()
+quint32 HttpMetaCache::internString(const QString &string, QByteArray &pending)
 {
-	// reset the save timer
-	saveBatchingTimer.stop();
-	saveBatchingTimer.start(30000);
+	if (string.isEmpty())
+		return 0;
+	auto iter = m_string_ids.constFind(string);
+	if (iter != m_string_ids.constEnd())
+		return *iter;
+	quint32 id = quint32(m_strings.size());
+	m_strings.append(string);
+	m_string_ids.insert(string, id);
+	writeString(pending, string);
+	return id;
 }
 
-void HttpMetaCache::SaveNow()
+bool HttpMetaCache::appendBinary()
 {
-	if(m_index_file.isNull())
-		return;
-	QJsonObject toplevel;
-	toplevel.insert("version", QJsonValue(QString("1")));
-	QJsonArray entriesArr;
-	for (auto group : m_entries)
+	QByteArray data;
+	int written = 0;
+	int knownStrings = m_strings.size();
+	for (auto iter = m_dirty.begin(); iter != m_dirty.end(); iter++)
 	{
-		for (auto entry : group.entry_list)
+		const QString &base = iter.key();
+		if (!m_entries.contains(base))
+			continue;
+		const auto &entrymap = m_entries[base];
+		for (const auto &path : iter.value())
 		{
-			// do not save stale entries. they are dead.
-			if(entry->stale)
+			EntryRecord record;
+			auto entry = entrymap.entry_list.value(path);
+			record.base = internString(base, data);
+			record.path = internString(path, data);
+			// removed and evicted entries are written as tombstones
+			if (!entry || entry->stale)
 			{
-				continue;
+				record.tag = tagTombstone;
+			}
+			else
+			{
+				record.etag = internString(entry->etag, data);
+				record.remoteTimestamp = internString(entry->remote_changed_timestamp, data);
+				setEntryData(record, entry->local_changed_timestamp, entry->md5sum);
 			}
-			QJsonObject entryObj;
-			entryObj.insert("base", QJsonValue(entry->baseId));
-			entryObj.insert("path", QJsonValue(entry->relativePath));
-			entryObj.insert("md5sum", QJsonValue(entry->md5sum));
-			entryObj.insert("etag", QJsonValue(entry->etag));
-			entryObj.insert("last_changed_timestamp",
-							QJsonValue(double(entry->local_changed_timestamp)));
-			if (!entry->remote_changed_timestamp.isEmpty())
-				entryObj.insert("remote_changed_timestamp",
-								QJsonValue(entry->remote_changed_timestamp));
-			entriesArr.append(entryObj);
+			writeEntry(data, record);
+			written++;
+		}
+	}
+
+	auto forgetNewStrings = [&]()
+	{
+		while (m_strings.size() > knownStrings)
+		{
+			m_string_ids.remove(m_strings.takeLast());
+		}
+	};
+
+	QFile index(m_binary_index_file);
+	if (!index.open(QIODevice::ReadWrite))
+	{
+		qWarning() << "Couldn't open" << m_binary_index_file << "for appending:" << index.errorString();
+		forgetNewStrings();
+		return false;
+	}
+	// drop anything we didn't understand when loading (like a partially written record)
+	if (index.size() != m_binary_size && !index.resize(m_binary_size))
+	{
+		forgetNewStrings();
+		return false;
+	}
+	if (!index.seek(m_binary_size) || index.write(data) != data.size() || !index.flush())
+	{
+		qWarning() << "Error appending to" << m_binary_index_file << ":" << index.errorString();
+		// whatever made it to the file will be ignored, or overwritten by the next successful write
+		index.resize(m_binary_size);
+		forgetNewStrings();
+		return false;
+	}
+	m_binary_size += data.size();
+	m_records += written;
+	m_dirty.clear();
+	return true;
+}
+
+bool HttpMetaCache::compactBinary()
+{
+	auto oldStrings = m_strings;
+	auto oldStringIds = m_string_ids;
+	m_strings.clear();
+	m_strings.append(QString());
+	m_string_ids.clear();
+
+	QByteArray data;
+	writeHeader(data);
+	int written = 0;
+	for (auto iter = m_entries.begin(); iter != m_entries.end(); iter++)
+	{
+		for (const auto &entry : iter->entry_list)
+		{
+			// do not save stale entries. they are dead.
+			if (entry->stale)
+				continue;
+			EntryRecord record;
+			record.base = internString(entry->baseId, data);
+			record.path = internString(entry->relativePath, data);
+			record.etag = internString(entry->etag, data);
+			record.remoteTimestamp = internString(entry->remote_changed_timestamp, data);
+			setEntryData(record, entry->local_changed_timestamp, entry->md5sum);
+			writeEntry(data, record);
+			written++;
 		}
 	}
-	toplevel.insert("entries", entriesArr);
 
-	QJsonDocument doc(toplevel);
 	try
 	{
-		FS::write(m_index_file, doc.toJson());
+		FS::write(m_binary_index_file, data);
 	}
 	catch (Exception & e)
 	{
 		qWarning() << e.what();
+		m_strings = oldStrings;
+		m_string_ids = oldStringIds;
+		return false;
+	}
+	m_binary_size = data.size();
+	m_records = written;
+	m_dirty.clear();
+	return true;
+}
+
+void HttpMetaCache::SaveEventually()
+{
+	// the timer belongs to the thread of the cache
+	if (QThread::currentThread() != thread())
+	{
+		QMetaObject::invokeMethod(this, "SaveEventually", Qt::QueuedConnection);
+		return;
+	}
+	// reset the save timer
+	saveBatchingTimer.stop();
+	saveBatchingTimer.start(30000);
+}
+
+void HttpMetaCache::SaveNow()
+{
+	if(m_index_file.isNull())
+		return;
+
+	QMutexLocker locker(&m_lock);
+	if (m_binary_size == 0)
+	{
+		compactBinary();
+		return;
+	}
+
+	if (m_dirty.isEmpty())
+		return;
+
+	int live = 0;
+	for (const auto &group : m_entries)
+	{
+		live += group.entry_list.size();
+	}
+	if (m_records > 2 * live + compactionSlack || !appendBinary())
+	{
+		compactBinary();
 	}
 }
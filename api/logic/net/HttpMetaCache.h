@@ -16,6 +16,12 @@
 #pragma once
 #include <QString>
 #include <QMap>
+#include <QSet>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QMutex>
+#include <QFuture>
 #include <qtimer.h>
 #include <memory>
 
@@ -79,6 +85,17 @@ protected:
 
 typedef std::shared_ptr<MetaEntry> MetaEntryPtr;
 
+/**
+ * Cache of HTTP metadata (etags, timestamps, checksums) for downloaded files.
+ *
+ * The index is kept in a versioned binary file (<path>.bin) that is memory mapped on load.
+ * It contains an interned string table and fixed-size entry records. Changes are appended
+ * to the end of the file and the file is compacted once it contains too many superseded records.
+ *
+ * The old JSON index at <path> is imported once if there is no binary index yet.
+ *
+ * Entry lookup and resolution is thread safe, so that files can be verified on the thread pool.
+ */
 class MULTIMC_LOGIC_EXPORT HttpMetaCache : public QObject
 {
 	Q_OBJECT
@@ -95,6 +112,11 @@ public:
 	MetaEntryPtr resolveEntry(QString base, QString resource_path,
 							  QString expected_etag = QString());
 
+	// resolve many entries of one base on the global thread pool.
+	// results are in the same order as the paths. Changed files are re-hashed in parallel, so
+	// any following resolveEntry calls for the same paths only have to check the timestamp.
+	QFuture<MetaEntryPtr> resolveEntries(QString base, QStringList resource_paths);
+
 	// add a previously resolved stale entry
 	bool updateEntry(MetaEntryPtr stale_entry);
 
@@ -103,17 +125,31 @@ public:
 
 	void addBase(QString base, QString base_root);
 
-	// (re)start a timer that calls SaveNow later.
-	void SaveEventually();
 	void Load();
 	QString getBasePath(QString base);
 public
 slots:
+	// (re)start a timer that calls SaveNow later.
+	void SaveEventually();
 	void SaveNow();
 
 private:
 	// create a new stale entry, given the parameters
 	MetaEntryPtr staleEntry(QString base, QString resource_path);
+	// remember that the entry at base/resource_path needs to be written to the index
+	void markDirty(const QString &base, const QString &resource_path);
+
+	// load the legacy JSON index
+	bool loadJson();
+	// load the binary index. returns false if it's missing or unusable
+	bool loadBinary();
+	// append all dirty entries to the binary index
+	bool appendBinary();
+	// rewrite the binary index from scratch, with only the live entries
+	bool compactBinary();
+	// get the id of a string in the index string table, queueing it for writing if it's new
+	quint32 internString(const QString &string, QByteArray &pending);
+
 	struct EntryMap
 	{
 		QString base_path;
@@ -121,5 +157,18 @@ private:
 	};
 	QMap<QString, EntryMap> m_entries;
 	QString m_index_file;
+	QString m_binary_index_file;
 	QTimer saveBatchingTimer;
+	// protects everything above and below
+	QMutex m_lock;
+
+	// base -> paths of entries changed since the last save
+	QMap<QString, QSet<QString>> m_dirty;
+	// string table of the binary index. id 0 is always the empty string
+	QVector<QString> m_strings;
+	QHash<QString, quint32> m_string_ids;
+	// size of the binary index up to the last complete record
+	qint64 m_binary_size = 0;
+	// number of entry records in the binary index, including superseded ones
+	int m_records = 0;
 };
@@ -15,16 +15,82 @@
 
 #include "NetJob.h"
 #include "Download.h"
+#include "HostScheduler.h"
+#include "Env.h"
 
 #include <QDebug>
 
+namespace
+{
+// parts known to be bigger than this are large, and can only take half of the slots of a job
+const qint64 largePartBytes = 1024 * 1024;
+}
+
+NetJob::NetJob(QString job_name) : Task()
+{
+	setObjectName(job_name);
+	connect(&ENV.hostScheduler(), &Net::HostScheduler::slotsAvailable, this, &NetJob::startMoreParts);
+}
+
+NetJob::~NetJob()
+{
+	for (auto index : m_doing)
+	{
+		releasePart(index, int(Net::HostScheduler::Outcome::Aborted));
+	}
+}
+
+void NetJob::releasePart(int index, int outcome)
+{
+	auto &slot = parts_progress[index];
+	if (slot.large)
+	{
+		m_doing_large--;
+	}
+	auto part = downloads[index];
+	ENV.hostScheduler().release(part->url().host(), Net::HostScheduler::Outcome(outcome), part->currentProgress(),
+								slot.timer.elapsed());
+}
+
+void NetJob::enqueue(int index)
+{
+	auto part = downloads[index];
+	auto &slot = parts_progress[index];
+	// for parts that were never started, the total is either the default, or a hint about the real size
+	slot.large = part->totalProgress() > largePartBytes;
+	auto &queue = m_todo[part->url().host()];
+	if (slot.large)
+	{
+		queue.large.enqueue(index);
+	}
+	else
+	{
+		queue.small.enqueue(index);
+	}
+	m_todo_count++;
+}
+
+QList<int> NetJob::todoParts() const
+{
+	QList<int> out;
+	for (const auto &queue : m_todo)
+	{
+		out.append(queue.small);
+		out.append(queue.large);
+	}
+	return out;
+}
+
 void NetJob::partSucceeded(int index)
 {
 	// do progress. all slots are 1 in size at least
 	auto &slot = parts_progress[index];
 	partProgress(index, slot.total_progress, slot.total_progress);
 
-	m_doing.remove(index);
+	if (m_doing.remove(index))
+	{
+		releasePart(index, int(Net::HostScheduler::Outcome::Succeeded));
+	}
 	m_done.insert(index);
 	downloads[index].get()->disconnect(this);
 	startMoreParts();
@@ -32,7 +98,10 @@ void NetJob::partSucceeded(int index)
 
 void NetJob::partFailed(int index)
 {
-	m_doing.remove(index);
+	if (m_doing.remove(index))
+	{
+		releasePart(index, int(Net::HostScheduler::Outcome::Failed));
+	}
 	auto &slot = parts_progress[index];
 	if (slot.failures == 3)
 	{
@@ -41,7 +110,7 @@ void NetJob::partFailed(int index)
 	else
 	{
 		slot.failures++;
-		m_todo.enqueue(index);
+		enqueue(index);
 	}
 	downloads[index].get()->disconnect(this);
 	startMoreParts();
@@ -50,7 +119,10 @@ void NetJob::partFailed(int index)
 void NetJob::partAborted(int index)
 {
 	m_aborted = true;
-	m_doing.remove(index);
+	if (m_doing.remove(index))
+	{
+		releasePart(index, int(Net::HostScheduler::Outcome::Aborted));
+	}
 	m_failed.insert(index);
 	downloads[index].get()->disconnect(this);
 	startMoreParts();
@@ -107,9 +179,9 @@ void NetJob::startMoreParts()
 	}
 	// OK. We are actively processing tasks, proceed.
 	// Check for final conditions if there's nothing in the queue.
-	if(!m_todo.size())
+	if(!m_todo_count)
 	{
-		if(!m_doing.size())
+		if(!m_doing.size() && !m_holdOpen)
 		{
 			if(!m_failed.size())
 			{
@@ -126,13 +198,59 @@ void NetJob::startMoreParts()
 		}
 		return;
 	}
-	// There's work to do, try to start more parts.
-	while (m_doing.size() < 6)
+	// There's work to do, try to start more parts, as far as the per-host limits allow.
+	// First pick the parts, then start them. Starting a part can finish it right away and get us back here.
+	auto &scheduler = ENV.hostScheduler();
+	QList<int> toStart;
+	// hosts take turns, one part each, starting with a different host every time
+	auto hosts = m_todo.keys();
+	if (hosts.size() > 1)
+	{
+		int first = m_nextHost++ % hosts.size();
+		hosts = hosts.mid(first) + hosts.mid(0, first);
+	}
+	bool started = true;
+	while (started)
+	{
+		started = false;
+		for (auto iter = hosts.begin(); iter != hosts.end();)
+		{
+			const QString &host = *iter;
+			auto &queue = m_todo[host];
+			bool takeLarge = queue.small.isEmpty();
+			// while small parts wait, large parts get at most half of the running parts
+			if (!takeLarge && queue.large.size())
+			{
+				takeLarge = m_doing_large < qMax(1, (m_doing.size() + 1) / 2);
+			}
+			if (!scheduler.tryAcquire(host))
+			{
+				// the host is full, it gets no more parts this time
+				iter = hosts.erase(iter);
+				continue;
+			}
+			int doThis = takeLarge ? queue.large.dequeue() : queue.small.dequeue();
+			m_todo_count--;
+			m_doing.insert(doThis);
+			auto &slot = parts_progress[doThis];
+			if (slot.large)
+			{
+				m_doing_large++;
+			}
+			slot.timer.start();
+			toStart.append(doThis);
+			started = true;
+			if (queue.small.isEmpty() && queue.large.isEmpty())
+			{
+				m_todo.remove(host);
+				iter = hosts.erase(iter);
+				continue;
+			}
+			iter++;
+		}
+	}
+	for (auto doThis : toStart)
 	{
-		if(!m_todo.size())
-			return;
-		int doThis = m_todo.dequeue();
-		m_doing.insert(doThis);
 		auto part = downloads[doThis];
 		// connect signals :D
 		connect(part.get(), SIGNAL(succeeded(int)), SLOT(partSucceeded(int)));
@@ -160,7 +278,7 @@ bool NetJob::canAbort() const
 {
 	bool canFullyAbort = true;
 	// can abort the waiting?
-	for(auto index: m_todo)
+	for(auto index: todoParts())
 	{
 		auto part = downloads[index];
 		canFullyAbort &= part->canAbort();
@@ -178,8 +296,9 @@ bool NetJob::abort()
 {
 	bool fullyAborted = true;
 	// fail all waiting
-	m_failed.unite(m_todo.toSet());
+	m_failed.unite(todoParts().toSet());
 	m_todo.clear();
+	m_todo_count = 0;
 	// abort active
 	auto toKill = m_doing.toList();
 	for(auto index: toKill)
@@ -206,7 +325,18 @@ bool NetJob::addNetAction(NetActionPtr action)
 	}
 	else
 	{
-		m_todo.append(parts_progress.size() - 1);
+		enqueue(parts_progress.size() - 1);
+		startMoreParts();
 	}
 	return true;
 }
+
+void NetJob::holdOpen(bool hold)
+{
+	m_holdOpen = hold;
+	if(!hold)
+	{
+		// there may be nothing left that would get us to finish
+		QMetaObject::invokeMethod(this, "startMoreParts", Qt::QueuedConnection);
+	}
+}
@@ -30,14 +30,17 @@ class MULTIMC_LOGIC_EXPORT NetJob : public Task
 {
 	Q_OBJECT
 public:
-	explicit NetJob(QString job_name) : Task()
-	{
-		setObjectName(job_name);
-	}
-	virtual ~NetJob() {}
+	explicit NetJob(QString job_name);
+	virtual ~NetJob();
 
 	bool addNetAction(NetActionPtr action);
 
+	/**
+	 * Keep the job running when it runs out of parts, because more are still coming.
+	 * Parts added to a running job are started right away.
+	 */
+	void holdOpen(bool hold);
+
 	NetActionPtr operator[](int index)
 	{
 		return downloads[index];
@@ -73,19 +76,40 @@ private slots:
 	void partFailed(int index);
 	void partAborted(int index);
 
+private:
+	// queue the part for starting
+	void enqueue(int index);
+	// all the parts waiting to be started
+	QList<int> todoParts() const;
+	// give the part's download slot back to the scheduler
+	void releasePart(int index, int outcome);
+
 private:
 	struct part_info
 	{
 		qint64 current_progress = 0;
 		qint64 total_progress = 1;
 		int failures = 0;
+		bool large = false;
+		QElapsedTimer timer;
+	};
+	// parts waiting for a slot, per host. Small parts are kept apart, so large ones can't starve them.
+	struct host_queue
+	{
+		QQueue<int> small;
+		QQueue<int> large;
 	};
 	QList<NetActionPtr> downloads;
 	QList<part_info> parts_progress;
-	QQueue<int> m_todo;
+	QMap<QString, host_queue> m_todo;
+	int m_todo_count = 0;
 	QSet<int> m_doing;
+	int m_doing_large = 0;
+	// the host startMoreParts() starts with next, so hosts that sort last don't only get the leftovers
+	int m_nextHost = 0;
 	QSet<int> m_done;
 	QSet<int> m_failed;
 	qint64 m_current_progress = 0;
 	bool m_aborted = false;
+	bool m_holdOpen = false;
 };
@@ -0,0 +1,97 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "net/NetJob.h"
+#include "net/HostScheduler.h"
+#include "Env.h"
+
+namespace
+{
+// a download that starts and then never finishes
+class StuckAction : public NetAction
+{
+	Q_OBJECT
+public:
+	StuckAction(const QUrl &url, qint64 size)
+	{
+		m_url = url;
+		m_total_progress = size;
+	}
+	static NetActionPtr make(const QString &host, int i, qint64 size)
+	{
+		return NetActionPtr(new StuckAction(QUrl(QString("https://%1/%2").arg(host).arg(i)), size));
+	}
+
+protected slots:
+	void downloadProgress(qint64, qint64) override {}
+	void downloadError(QNetworkReply::NetworkError) override {}
+	void downloadFinished() override {}
+	void downloadReadyRead() override {}
+
+public slots:
+	void start() override
+	{
+		m_status = Job_InProgress;
+		emit started(m_index_within_job);
+	}
+};
+
+int running(NetJob &job, const QString &host = QString())
+{
+	int count = 0;
+	for (int i = 0; i < job.size(); i++)
+	{
+		auto part = job[i];
+		if (part->isRunning() && (host.isNull() || part->url().host() == host))
+		{
+			count++;
+		}
+	}
+	return count;
+}
+}
+
+class NetJobTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void init()
+	{
+		ENV.hostScheduler().setLimits(2, 24, 48);
+	}
+
+	void test_largePartsRunTogether()
+	{
+		NetJob job("large");
+		for (int i = 0; i < 10; i++)
+		{
+			job.addNetAction(StuckAction::make("large.example", i, 100 * 1024 * 1024));
+		}
+		job.start();
+		QTRY_VERIFY(running(job) > 0);
+		// only the per-host limit holds them back
+		QCOMPARE(running(job), ENV.hostScheduler().limit("large.example"));
+		QVERIFY(running(job) > 1);
+	}
+
+	void test_hostsTakeTurns()
+	{
+		// fewer slots in total than one host could take
+		ENV.hostScheduler().setLimits(2, 24, 4);
+		NetJob job("hosts");
+		for (int i = 0; i < 10; i++)
+		{
+			job.addNetAction(StuckAction::make("a.example", i, 1024));
+			job.addNetAction(StuckAction::make("z.example", i, 1024));
+		}
+		job.start();
+		QTRY_COMPARE(running(job), 4);
+		QCOMPARE(running(job, "a.example"), 2);
+		QCOMPARE(running(job, "z.example"), 2);
+	}
+};
+
+QTEST_GUILESS_MAIN(NetJobTest)
+
+#include "NetJob_test.moc"
@@ -23,6 +23,12 @@ INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
 	m_ini.loadFile(path);
 }
 
+INISettingsObject::INISettingsObject(const QString &path, const INIFile &contents, QObject *parent)
+	: SettingsObject(parent), m_ini(contents)
+{
+	m_filePath = path;
+}
+
 void INISettingsObject::setFilePath(const QString &filePath)
 {
 	m_filePath = filePath;
@@ -31,6 +31,8 @@ class MULTIMC_LOGIC_EXPORT INISettingsObject : public SettingsObject
 	Q_OBJECT
 public:
 	explicit INISettingsObject(const QString &path, QObject *parent = 0);
+	/// Use the already loaded contents of the file at @path
+	INISettingsObject(const QString &path, const INIFile &contents, QObject *parent = 0);
 
 	/*!
 	 * \brief Gets the path to the INI file.
@@ -16,6 +16,7 @@
 #include "Task.h"
 
 #include <QDebug>
+#include <limits>
 
 Task::Task(QObject *parent) : QObject(parent)
 {
@@ -37,6 +38,17 @@ void Task::setProgress(qint64 current, qint64 total)
 	emit progress(m_progress, m_progressTotal);
 }
 
+void Task::reportProgress(qint64 current, qint64 total)
+{
+	// progress is kept as an int
+	while(total > std::numeric_limits<int>::max())
+	{
+		current >>= 10;
+		total >>= 10;
+	}
+	QMetaObject::invokeMethod(this, "setProgress", Qt::QueuedConnection, Q_ARG(qint64, current), Q_ARG(qint64, total));
+}
+
 void Task::start()
 {
 	m_running = true;
@@ -72,6 +72,12 @@ public slots:
 protected:
 	virtual void executeTask() = 0;
 
+	/**
+	 * Set the progress from any thread. It is handed over to the thread of the task.
+	 * Big counts, like bytes, are scaled down to fit the progress bars.
+	 */
+	void reportProgress(qint64 current, qint64 total);
+
 protected slots:
 	virtual void emitSucceeded();
 	virtual void emitAborted();
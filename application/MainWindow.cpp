@@ -811,7 +811,10 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new MainWindow
 		checker->checkForNotifications();
 	}
 
-	setSelectedInstanceById(MMC->settings()->get("SelectedInstance").toString());
+	// instances are loaded in the background, the last selected one may only show up later
+	m_instanceToSelect = MMC->settings()->get("SelectedInstance").toString();
+	connect(MMC->instances().get(), &InstanceList::rowsInserted, this, &MainWindow::instancesAdded);
+	setSelectedInstanceById(m_instanceToSelect);
 
 	// removing this looks stupid
 	view->setFocus();
@@ -1442,6 +1445,14 @@ void MainWindow::setSelectedInstanceById(const QString &id)
 	}
 }
 
+void MainWindow::instancesAdded()
+{
+	if (!m_selectedInstance && !m_instanceToSelect.isEmpty())
+	{
+		setSelectedInstanceById(m_instanceToSelect);
+	}
+}
+
 void MainWindow::on_actionChangeInstGroup_triggered()
 {
 	if (!m_selectedInstance)
@@ -1730,6 +1741,11 @@ void MainWindow::startTask(Task *task)
 
 void MainWindow::instanceChanged(const QModelIndex &current, const QModelIndex &previous)
 {
+	// the instance we are leaving does not need its profile and mod lists loaded anymore
+	if (m_selectedInstance && m_selectedInstance->id() != current.data(InstanceList::InstanceIDRole).toString())
+	{
+		m_selectedInstance->releaseResources();
+	}
 	if (!current.isValid())
 	{
 		MMC->settings()->set("SelectedInstance", QString());
@@ -1740,6 +1756,7 @@ void MainWindow::instanceChanged(const QModelIndex &current, const QModelIndex &
 	m_selectedInstance = MMC->instances()->getInstanceById(id);
 	if (m_selectedInstance)
 	{
+		m_instanceToSelect.clear();
 		ui->instanceToolBar->setEnabled(true);
 		if(m_selectedInstance->isRunning())
 		{
@@ -175,6 +175,8 @@ private slots:
 
 	void droppedURLs(QList<QUrl> urls);
 
+	void instancesAdded();
+
 private:
 	void addInstance(QString url = QString());
 	void activateInstance(InstancePtr instance);
@@ -204,6 +206,8 @@ private:
 	unique_qobject_ptr<NotificationChecker> m_notificationChecker;
 
 	InstancePtr m_selectedInstance;
+	// the instance to select once it's loaded
+	QString m_instanceToSelect;
 	QString m_currentInstIcon;
 
 	// managed by the application object
@@ -40,6 +40,7 @@
 #include <minecraft/auth/MojangAccountList.h>
 #include "icons/IconList.h"
 #include "net/HttpMetaCache.h"
+#include "net/HostScheduler.h"
 #include "net/URLConstants.h"
 #include "Env.h"
 
@@ -453,6 +454,14 @@ MultiMC::MultiMC(int &argc, char **argv) : QApplication(argc, argv)
 		m_settings->registerSetting({"ProxyUser", "ProxyUsername"}, "");
 		m_settings->registerSetting({"ProxyPass", "ProxyPassword"}, "");
 
+		// Download concurrency - the per-host limit adapts between the min and max
+		m_settings->registerSetting("DownloadsMinPerHost", 2);
+		m_settings->registerSetting("DownloadsMaxPerHost", 24);
+		m_settings->registerSetting("DownloadsMaxTotal", 48);
+
+		// Hash the assets already present on every update, not just check their sizes
+		m_settings->registerSetting("VerifyAssets", false);
+
 		// Memory
 		m_settings->registerSetting({"MinMemAlloc", "MinMemoryAlloc"}, 512);
 		m_settings->registerSetting({"MaxMemAlloc", "MaxMemoryAlloc"}, 1024);
@@ -595,8 +604,10 @@ MultiMC::MultiMC(int &argc, char **argv) : QApplication(argc, argv)
 		connect(InstDirSetting.get(), &Setting::SettingChanged, m_instanceFolder, &FolderInstanceProvider::on_InstFolderChanged);
 		m_instances->addInstanceProvider(m_instanceFolder);
 		qDebug() << "Loading Instances...";
+		// show what was there last time right away, then check it in the background
+		m_instances->loadSnapshot();
 		m_instances->loadList(true);
-		qDebug() << "<> Instances loaded.";
+		qDebug() << "<> Instances are loading in the background.";
 	}
 
 	// and accounts
@@ -625,6 +636,14 @@ MultiMC::MultiMC(int &argc, char **argv) : QApplication(argc, argv)
 		qDebug() << "<> Proxy settings done.";
 	}
 
+	// init download limits
+	{
+		int minPerHost = settings()->get("DownloadsMinPerHost").toInt();
+		int maxPerHost = settings()->get("DownloadsMaxPerHost").toInt();
+		int maxTotal = settings()->get("DownloadsMaxTotal").toInt();
+		ENV.hostScheduler().setLimits(minPerHost, maxPerHost, maxTotal);
+	}
+
 	// now we have network, download translation updates
 	m_translations->downloadIndex();
 
@@ -780,9 +799,16 @@ void MultiMC::setupWizardFinished(int status)
 void MultiMC::performMainStartupAction()
 {
 	m_status = MultiMC::Initialized;
+	disconnect(m_instances.get(), &InstanceList::listLoaded, this, &MultiMC::performMainStartupAction);
 	if(!m_instanceIdToLaunch.isEmpty())
 	{
 		auto inst = instances()->getInstanceById(m_instanceIdToLaunch);
+		if(!inst && instances()->isLoading())
+		{
+			// it may not be loaded yet, look again when all instances are
+			connect(m_instances.get(), &InstanceList::listLoaded, this, &MultiMC::performMainStartupAction);
+			return;
+		}
 		if(inst)
 		{
 			qDebug() << "<> Instance launching:" << m_instanceIdToLaunch;
@@ -16,7 +16,7 @@
 #include "ExportInstanceDialog.h"
 #include "ui_ExportInstanceDialog.h"
 #include <BaseInstance.h>
-#include <MMCZip.h>
+#include <InstanceExportTask.h>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <qfilesystemmodel.h>
@@ -28,6 +28,7 @@
 #include "MMCStrings.h"
 #include "SeparatorPrefixTree.h"
 #include "MultiMC.h"
+#include "ProgressDialog.h"
 #include <icons/IconList.h>
 #include <FileSystem.h>
 
@@ -406,11 +407,12 @@ bool ExportInstanceDialog::doExport()
 
 	SaveIcon(m_instance);
 
-	auto & blocked = proxyModel->blockedPaths();
-	using std::placeholders::_1;
-	if (!JlCompress::compressDir(output, m_instance->instanceRoot(), name, std::bind(&SeparatorPrefixTree<'/'>::covers, blocked, _1)))
+	InstanceExportTask task(m_instance, output, name, proxyModel->blockedPaths());
+	ProgressDialog progress(this);
+	progress.setSkipButton(true, tr("Abort"));
+	if (!progress.execWithTask(&task))
 	{
-		QMessageBox::warning(this, tr("Error"), tr("Unable to export instance"));
+		QMessageBox::warning(this, tr("Error"), tr("Unable to export instance: %1").arg(task.failReason()));
 		return false;
 	}
 	return true;
@@ -49,60 +49,6 @@ public:
 		m_colors.reset(colors);
 	}
 
-	QModelIndex find(const QModelIndex &start, const QString &value, bool reverse) const
-	{
-		QModelIndex parentIndex = parent(start);
-		auto compare = [&](int r) -> QModelIndex
-		{
-			QModelIndex idx = index(r, start.column(), parentIndex);
-			if (!idx.isValid() || idx == start)
-			{
-				return QModelIndex();
-			}
-			QVariant v = data(idx, Qt::DisplayRole);
-			QString t = v.toString();
-			if (t.contains(value, Qt::CaseInsensitive))
-				return idx;
-			return QModelIndex();
-		};
-		if(reverse)
-		{
-			int from = start.row();
-			int to = 0;
-
-			for (int i = 0; i < 2; ++i)
-			{
-				for (int r = from; (r >= to); --r)
-				{
-					auto idx = compare(r);
-					if(idx.isValid())
-						return idx;
-				}
-				// prepare for the next iteration
-				from = rowCount() - 1;
-				to = start.row();
-			}
-		}
-		else
-		{
-			int from = start.row();
-			int to = rowCount(parentIndex);
-
-			for (int i = 0; i < 2; ++i)
-			{
-				for (int r = from; (r < to); ++r)
-				{
-					auto idx = compare(r);
-					if(idx.isValid())
-						return idx;
-				}
-				// prepare for the next iteration
-				from = 0;
-				to = start.row();
-			}
-		}
-		return QModelIndex();
-	}
 private:
 	QFont m_font;
 	std::unique_ptr<LogColorCache> m_colors;
@@ -146,7 +92,7 @@ LogPage::LogPage(InstancePtr instance, QWidget *parent)
 		connect(m_instance.get(), &BaseInstance::launchTaskChanged, this, &LogPage::on_InstanceLaunchTask_changed);
 	}
 
-	ui->text->setWordWrap(true);
+	ui->text->setWordWrap(ui->wrapCheckbox->isChecked());
 
 	auto findShortcut = new QShortcut(QKeySequence(QKeySequence::Find), this);
 	connect(findShortcut, SIGNAL(activated()), SLOT(findActivated()));
@@ -236,21 +182,36 @@ void LogPage::on_wrapCheckbox_clicked(bool checked)
 	ui->text->setWordWrap(checked);
 }
 
+void LogPage::findNext(bool reverse)
+{
+	if(!m_model)
+		return;
+	// the search goes through the log model, the proxy doesn't change the rows
+	auto current = ui->text->currentIndex();
+	int from = current.isValid() ? current.row() : (reverse ? m_model->rowCount() : -1);
+	int row = m_model->find(ui->searchBar->text(), from, reverse);
+	if(row < 0)
+		return;
+	auto index = m_proxy->index(row, 0);
+	ui->text->setCurrentIndex(index);
+	ui->text->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
 void LogPage::on_findButton_clicked()
 {
 	auto modifiers = QApplication::keyboardModifiers();
 	bool reverse = modifiers & Qt::ShiftModifier;
-	ui->text->findNext(ui->searchBar->text(), reverse);
+	findNext(reverse);
 }
 
 void LogPage::findNextActivated()
 {
-	ui->text->findNext(ui->searchBar->text(), false);
+	findNext(false);
 }
 
 void LogPage::findPreviousActivated()
 {
-	ui->text->findNext(ui->searchBar->text(), true);
+	findNext(true);
 }
 
 void LogPage::findActivated()
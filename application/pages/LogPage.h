@@ -71,6 +71,9 @@ private slots:
 
 	void on_InstanceLaunchTask_changed(std::shared_ptr<LaunchTask> proc);
 
+private:
+	void findNext(bool reverse);
+
 private:
 	Ui::LogPage *ui;
 	InstancePtr m_instance;
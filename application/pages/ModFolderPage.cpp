@@ -56,6 +56,11 @@ ModFolderPage::ModFolderPage(BaseInstance *inst, std::shared_ptr<ModList> mods,
 	ui->modTreeView->sortByColumn(1, Qt::AscendingOrder);
 	auto smodel = ui->modTreeView->selectionModel();
 	connect(smodel, &QItemSelectionModel::currentChanged, this, &ModFolderPage::modCurrent);
+	// mod details arrive after the list is shown
+	connect(m_mods.get(), &ModList::dataChanged, this, [this, smodel]()
+	{
+		modCurrent(smodel->currentIndex(), QModelIndex());
+	});
 	connect(ui->filterEdit, &QLineEdit::textChanged, this, &ModFolderPage::on_filterTextChanged );
 }
 
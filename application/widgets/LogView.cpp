@@ -1,75 +1,52 @@
 #include "LogView.h"
-#include <QTextBlock>
 #include <QScrollBar>
+#include <QKeyEvent>
+#include <QApplication>
+#include <QClipboard>
+#include <algorithm>
 
-LogView::LogView(QWidget* parent) : QPlainTextEdit(parent)
+LogView::LogView(QWidget* parent) : QListView(parent)
 {
-	setWordWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-	m_defaultFormat = new QTextCharFormat(currentCharFormat());
+	setSelectionMode(QAbstractItemView::ExtendedSelection);
+	setTextElideMode(Qt::ElideNone);
+	setResizeMode(QListView::Adjust);
+	setBatchSize(1000);
+	setWordWrap(false);
 }
 
 LogView::~LogView()
 {
-	delete m_defaultFormat;
 }
 
 void LogView::setWordWrap(bool wrapping)
 {
+	QListView::setWordWrap(wrapping);
+	// all lines are the same height, unless they wrap
+	setUniformItemSizes(!wrapping);
 	if(wrapping)
 	{
+		// every line has to be measured, including the spilled ones - do it a bit at a time
+		setLayoutMode(QListView::Batched);
 		setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-		setLineWrapMode(QPlainTextEdit::WidgetWidth);
 	}
 	else
 	{
+		setLayoutMode(QListView::SinglePass);
 		setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-		setLineWrapMode(QPlainTextEdit::NoWrap);
 	}
 }
 
 void LogView::setModel(QAbstractItemModel* model)
 {
-	if(m_model)
+	if(this->model())
 	{
-		disconnect(m_model, &QAbstractItemModel::modelReset, this, &LogView::repopulate);
-		disconnect(m_model, &QAbstractItemModel::rowsInserted, this, &LogView::rowsInserted);
-		disconnect(m_model, &QAbstractItemModel::rowsAboutToBeInserted, this, &LogView::rowsAboutToBeInserted);
-		disconnect(m_model, &QAbstractItemModel::rowsRemoved, this, &LogView::rowsRemoved);
+		disconnect(this->model(), &QAbstractItemModel::rowsAboutToBeInserted, this, &LogView::rowsAboutToBeInserted);
 	}
-	m_model = model;
-	if(m_model)
+	QListView::setModel(model);
+	if(model)
 	{
-		connect(m_model, &QAbstractItemModel::modelReset, this, &LogView::repopulate);
-		connect(m_model, &QAbstractItemModel::rowsInserted, this, &LogView::rowsInserted);
-		connect(m_model, &QAbstractItemModel::rowsAboutToBeInserted, this, &LogView::rowsAboutToBeInserted);
-		connect(m_model, &QAbstractItemModel::rowsRemoved, this, &LogView::rowsRemoved);
-		connect(m_model, &QAbstractItemModel::destroyed, this, &LogView::modelDestroyed);
+		connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, &LogView::rowsAboutToBeInserted);
 	}
-	repopulate();
-}
-
-QAbstractItemModel * LogView::model() const
-{
-	return m_model;
-}
-
-void LogView::modelDestroyed(QObject* model)
-{
-	if(m_model == model)
-	{
-		setModel(nullptr);
-	}
-}
-
-void LogView::repopulate()
-{
-	auto doc = document();
-	doc->clear();
-	if(!m_model)
-	{
-		return;
-	}
-	rowsInserted(QModelIndex(), 0, m_model->rowCount() - 1);
 }
 
 void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int last)
@@ -92,31 +69,7 @@ void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int la
 
 void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 {
-	for(int i = first; i <= last; i++)
-	{
-		auto idx = m_model->index(i, 0, parent);
-		auto text = m_model->data(idx, Qt::DisplayRole).toString();
-		QTextCharFormat format(*m_defaultFormat);
-		auto font = m_model->data(idx, Qt::FontRole);
-		if(font.isValid())
-		{
-			format.setFont(font.value<QFont>());
-		}
-		auto fg = m_model->data(idx, Qt::TextColorRole);
-		if(fg.isValid())
-		{
-			format.setForeground(fg.value<QColor>());
-		}
-		auto bg = m_model->data(idx, Qt::BackgroundRole);
-		if(bg.isValid())
-		{
-			format.setBackground(bg.value<QColor>());
-		}
-		auto workCursor = textCursor();
-		workCursor.movePosition(QTextCursor::End);
-		workCursor.insertText(text, format);
-		workCursor.insertBlock();
-	}
+	QListView::rowsInserted(parent, first, last);
 	if(m_scroll && !m_scrolling)
 	{
 		m_scrolling = true;
@@ -124,21 +77,26 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 	}
 }
 
-void LogView::rowsRemoved(const QModelIndex& parent, int first, int last)
-{
-	// TODO: some day... maybe
-	Q_UNUSED(parent)
-	Q_UNUSED(first)
-	Q_UNUSED(last)
-}
-
 void LogView::scrollToBottom()
 {
 	m_scrolling = false;
-	verticalScrollBar()->setSliderPosition(verticalScrollBar()->maximum());
+	QListView::scrollToBottom();
 }
 
-void LogView::findNext(const QString& what, bool reverse)
+void LogView::keyPressEvent(QKeyEvent* event)
 {
-	find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
+	if(event->matches(QKeySequence::Copy) && model())
+	{
+		auto rows = selectionModel()->selectedRows();
+		std::sort(rows.begin(), rows.end());
+		QStringList lines;
+		for(auto & row: rows)
+		{
+			lines.append(row.data(Qt::DisplayRole).toString());
+		}
+		QApplication::clipboard()->setText(lines.join('\n'));
+		event->accept();
+		return;
+	}
+	QListView::keyPressEvent(event);
 }
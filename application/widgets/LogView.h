@@ -1,36 +1,36 @@
 #pragma once
-#include <QPlainTextEdit>
-#include <QAbstractItemView>
+#include <QListView>
 
 class QAbstractItemModel;
 
-class LogView: public QPlainTextEdit
+/*
+ * A view of a log model. Only the lines on screen are asked for, so it works for logs of any length.
+ */
+class LogView: public QListView
 {
 	Q_OBJECT
 public:
 	explicit LogView(QWidget *parent = nullptr);
 	virtual ~LogView();
 
-	virtual void setModel(QAbstractItemModel *model);
-	QAbstractItemModel *model() const;
+	void setModel(QAbstractItemModel *model) override;
 
 public slots:
+	/*
+	 * Off by default. Wrapped lines have different heights, so the view has to measure every line
+	 * of the log, which also reads back the lines that were spilled to disk.
+	 */
 	void setWordWrap(bool wrapping);
-	void findNext(const QString & what, bool reverse);
 	void scrollToBottom();
 
 protected slots:
-	void repopulate();
-	// note: this supports only appending
-	void rowsInserted(const QModelIndex &parent, int first, int last);
+	void rowsInserted(const QModelIndex &parent, int first, int last) override;
 	void rowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
-	// note: this supports only removing from front
-	void rowsRemoved(const QModelIndex &parent, int first, int last);
-	void modelDestroyed(QObject * model);
 
 protected:
-	QAbstractItemModel *m_model = nullptr;
-	QTextCharFormat *m_defaultFormat = nullptr;
+	void keyPressEvent(QKeyEvent *event) override;
+
+protected:
 	bool m_scroll = false;
 	bool m_scrolling = false;
 };